@@ -20,10 +20,6 @@
 #include "EasyPlatform.h"
 #include <cassert>
 
-#define WIN32_LEAN_AND_MEAN
-#define NOMINMAX
-#include <windows.h>
-
 static const char * platform_library_name = "EasyPlatform.dll";
 static const char * platform_library_entry_point = "EasyPlatformFactory";
 
@@ -48,8 +44,7 @@ namespace engine {
             }
 
             auto * factory =
-                (utils::interfaces::IPlatform::TEntryFunction *)
-                    GetProcAddress(libraryHandler(), platform_library_entry_point);
+                (utils::interfaces::IPlatform::TEntryFunction *)symbol(platform_library_entry_point);
             m_interface = factory();
             assert(m_interface);
 
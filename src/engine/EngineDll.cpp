@@ -18,17 +18,20 @@
 ****************************************************************************************/
 
 #include "Framework.h"
+#include <LibraryHandler.h>
 
+#if defined(_WIN32)
 #define WIN32_LEAN_AND_MEAN
 #define NOMINMAX
 #include <windows.h>
+#endif
 
 #include "ISystemGlobalEnvironment.h"
 utils::interfaces::SSystemGlobalEnvironment * g_env = nullptr;
 
 extern "C"
 {
-    __declspec(dllexport) utils::interfaces::IFramework * create_engine(
+    LIBRARY_EXPORT utils::interfaces::IFramework * create_engine(
         utils::interfaces::SSystemGlobalEnvironment * env)
     {
         g_env = env;
@@ -36,7 +39,7 @@ extern "C"
         return g_env->pFramework;
     }
 
-    __declspec(dllexport) void destroy_engine()
+    LIBRARY_EXPORT void destroy_engine()
     {
         if (g_env->pFramework != nullptr)
         {
@@ -47,7 +50,9 @@ extern "C"
     }
 };
 
+#if defined(_WIN32)
 BOOL APIENTRY dllMain(HMODULE hModule, DWORD ul_reason_for_call, LPVOID lpReserved)
 {
     return TRUE;
 }
+#endif
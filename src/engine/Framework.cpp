@@ -21,30 +21,49 @@
 #include "GraphicContainer.h"
 #include "LibraryHandler.h"
 #include "PlatformFactory.h"
+#include "RenderThread.h"
 #include "VariablesManager.h"
 #include <ContainersUtils.h>
+#include <DrawTrace.h>
+#include <IPlatformBatch.h>
 #include <Path.h>
+#include <Picture.h>
+#include <TextureAtlas.h>
 #include <cassert>
+#include <chrono>
 #include <ctime>
 #include <iostream>
 
 #include "ISystemGlobalEnvironment.h"
 extern utils::interfaces::SSystemGlobalEnvironment * g_env;
 
-#define WIN32_LEAN_AND_MEAN
-#define NOMINMAX
-#include <windows.h>
-
 namespace engine {
 
+#if defined(_WIN32)
     static const char * game_library_name = "Game.dll";
+#else
+    static const char * game_library_name = "libgame.so";
+#endif
     static const char * game_library_entry_point_create = "create_game";
     static const char * game_library_entry_point_destroy = "destroy_game";
 
-    CFramework::CFramework() { makeApplicationPath(); }
+    CFramework::CFramework()
+        : m_bitmapPool(sizeof(graphic::CGraphicBitmap))
+        , m_textfieldPool(sizeof(graphic::CGraphicTextfield))
+        , m_containerPool(sizeof(graphic::CGraphicContainer))
+    {
+        makeApplicationPath();
+    }
 
     CFramework::~CFramework()
     {
+        delete m_pRenderThread;
+        m_pRenderThread = nullptr;
+
+        // The window goes back to its pool before the pools are destroyed
+        delete m_pWindow;
+        m_pWindow = nullptr;
+
         spriteDeferredDestruction();
         delete m_pPlatformManager;
         delete m_pVariablesManager;
@@ -52,12 +71,7 @@ namespace engine {
 
     void CFramework::makeApplicationPath()
     {
-        char buffer[MAX_PATH];
-        GetModuleFileName(nullptr, buffer, MAX_PATH);
-
-        std::string buffer_string(buffer);
-        std::string::size_type pos = buffer_string.find_last_of("\\/");
-        m_applicationPath = buffer_string.substr(0, pos + 1);
+        m_applicationPath = utils::path_utils::executablePath() + "/";
     }
 
     bool CFramework::init()
@@ -92,6 +106,48 @@ namespace engine {
             return false;
         }
 
+        // The texts can be drawn from the atlas even if the game packs no picture
+        utils::CTextureAtlas atlas;
+        if (!packAtlas(atlas))
+        {
+            return false;
+        }
+
+        utils::interfaces::IVariable * p_variable =
+            m_pVariablesManager->variable("sys_damageTracking");
+        m_damageTracking = (p_variable != nullptr) && p_variable->value<bool>();
+        graphic::CGraphicItem::setDamageTracking(m_damageTracking);
+
+        p_variable = m_pVariablesManager->variable("sys_renderThread");
+        if ((p_variable != nullptr) && p_variable->value<bool>())
+        {
+            utils::interfaces::IPlatformBatch * p_batch = m_pPlatformManager->batch();
+            if (p_batch != nullptr)
+            {
+                p_variable = m_pVariablesManager->variable("sys_renderThreadBuffers");
+                m_pRenderThread = new CRenderThread(
+                    p_batch, p_variable != nullptr ? p_variable->value<unsigned int>() : 2);
+            }
+            else
+            {
+                std::cout << "[INFO] The platform cannot draw from a render thread, the frames "
+                             "are drawn by the main thread"
+                          << std::endl;
+            }
+        }
+
+        p_variable = m_pVariablesManager->variable("sys_drawTrace");
+        if ((p_variable != nullptr) && !p_variable->value<std::string>().empty())
+        {
+            const std::string trace_path = m_applicationPath + p_variable->value<std::string>();
+            if (!m_drawTrace.open(trace_path.c_str(), width, height))
+            {
+                std::cerr << "[ERROR] Draw trace " << trace_path.c_str() << " cannot be created"
+                          << std::endl;
+                return false;
+            }
+        }
+
         m_pWindow = new graphic::CGraphicContainer();
         m_pWindow->setSize(width, height);
 
@@ -119,8 +175,8 @@ namespace engine {
             return -1;
         }
 
-        auto create_game = (utils::interfaces::IGame::TEntryFunctionCreate)
-            GetProcAddress(game_dll.libraryHandler(), game_library_entry_point_create);
+        auto create_game = (utils::interfaces::IGame::TEntryFunctionCreate)game_dll.symbol(
+            game_library_entry_point_create);
         if (create_game == nullptr)
         {
             std::cerr << "[ERROR] Specified " << game_dll.libraryName() << " doesn't have a valid "
@@ -147,7 +203,11 @@ namespace engine {
             float time = p_platform->getElapsedTime();
             float delta = time - m_time;
 
+            graphic::CGraphicItem::advanceFrame();
+
+            acquireDrawList();
             m_pWindow->paint();
+            submitDrawList();
 
             onUpdate(delta);
 
@@ -178,6 +238,8 @@ namespace engine {
                     : utils::interfaces::CInputKey::key_status::inactive);
             onInput(m_keyRight, delta);
 
+            m_pWindow->updateContacts();
+
             if (!p_game->refresh())
             {
                 std::cerr << "[ERROR] Game can't refresh" << std::endl;
@@ -187,22 +249,40 @@ namespace engine {
             m_time = time;
         }
 
-        spriteDeferredDestruction();
-        p_platform->destroy();
+        // The queued draw lists refer to the sprites
+        delete m_pRenderThread;
+        m_pRenderThread = nullptr;
+
+        int ret_value = 0;
 
-        auto destroy_game = (utils::interfaces::IGame::TEntryFunctionDestroy)
-            GetProcAddress(game_dll.libraryHandler(), game_library_entry_point_destroy);
+        // The game and its items go first, while the game library and the platform are loaded
+        auto destroy_game = (utils::interfaces::IGame::TEntryFunctionDestroy)game_dll.symbol(
+            game_library_entry_point_destroy);
         if (destroy_game == nullptr)
         {
             std::cerr << "[ERROR] Specified " << game_dll.libraryName() << " doesn't have a valid "
                       << game_library_entry_point_destroy << " entry point" << std::endl;
 
-            return -1;
+            ret_value = -1;
+        }
+        else
+        {
+            destroy_game();
         }
 
-        destroy_game();
+        destroyWindowItems();
+
+        spriteDeferredDestruction();
+        p_platform->destroy();
+
+        if (m_drawTrace.isOpen())
+        {
+            m_drawTrace.close();
+            std::cout << "[INFO] Draw trace recorded " << m_drawTrace.frames() << " frames in "
+                      << m_drawTrace.bytes() << " bytes" << std::endl;
+        }
 
-        return 0;
+        return ret_value;
     }
 
     utils::interfaces::IPlatformManager * CFramework::platformManager()
@@ -220,30 +300,355 @@ namespace engine {
         return m_pPlatformManager->platform();
     }
 
+    int CFramework::replay(const char * tracePath)
+    {
+        assert(tracePath && tracePath[0]);
+
+        if (m_pPlatformManager == nullptr)
+        {
+            std::cerr << "[ERROR] Platform manager not initialized" << std::endl;
+            return -1;
+        }
+
+        utils::interfaces::IPlatform * p_platform = m_pPlatformManager->platform();
+        if (p_platform == nullptr)
+        {
+            std::cerr << "[ERROR] Platform not initialized" << std::endl;
+            return -1;
+        }
+
+        utils::CDrawTraceReader trace;
+        if (!trace.open(tracePath))
+        {
+            std::cerr << "[ERROR] Draw trace " << tracePath << " cannot be read" << std::endl;
+            return -1;
+        }
+
+        if ((trace.width() != (int)m_pWindow->size().width()) ||
+            (trace.height() != (int)m_pWindow->size().height()))
+        {
+            std::cerr << "[ERROR] Draw trace " << tracePath << " has been recorded in a "
+                      << trace.width() << "x" << trace.height() << " window" << std::endl;
+            return -1;
+        }
+
+        // The trace has no damage, every frame is drawn in full
+        m_damageTracking = false;
+        m_drawTrace.close();
+
+        std::vector<utils::interfaces::ISprite *> sprites;
+        utils::CDrawTraceReader::SRecord record;
+        unsigned int frames = 0;
+        bool end_of_trace = false;
+        int ret_value = 0;
+
+        const auto start_time = std::chrono::steady_clock::now();
+        while (!end_of_trace && p_platform->update())
+        {
+            acquireDrawList();
+
+            for (;;)
+            {
+                if (!trace.read(record))
+                {
+                    end_of_trace = true;
+                    break;
+                }
+
+                if (record.type == utils::CDrawTraceReader::record_type::frame)
+                {
+                    break;
+                }
+
+                if (record.type == utils::CDrawTraceReader::record_type::sprite)
+                {
+                    if (sprites.size() <= record.sprite)
+                    {
+                        sprites.resize(record.sprite + 1, nullptr);
+                    }
+
+                    sprites[record.sprite] = createSprite(record.text.c_str());
+                }
+                else if (record.type == utils::CDrawTraceReader::record_type::text)
+                {
+                    m_pDrawList->addText(record.x, record.y, record.text.c_str());
+                }
+                else if (record.type == utils::CDrawTraceReader::record_type::glyph)
+                {
+                    const graphic::CGlyphAtlas * p_glyphs = glyphAtlas();
+                    if (p_glyphs != nullptr)
+                    {
+                        m_pDrawList->addGlyph(record.x,
+                                              record.y,
+                                              record.text[0],
+                                              p_glyphs->glyphRectangle(record.text[0]));
+                    }
+                    else
+                    {
+                        m_pDrawList->addText(record.x, record.y, record.text.c_str());
+                    }
+                }
+                else if ((record.sprite < sprites.size()) && (sprites[record.sprite] != nullptr))
+                {
+                    m_pDrawList->addSprite(sprites[record.sprite], record.x, record.y);
+                }
+                else
+                {
+                    std::cerr << "[ERROR] Draw trace " << tracePath << " draws sprite "
+                              << record.sprite << " before defining it" << std::endl;
+                    end_of_trace = true;
+                    ret_value = -1;
+                    break;
+                }
+            }
+
+            // The draws after the last frame delimiter are not a whole frame
+            if (end_of_trace)
+            {
+                m_pDrawList->clear();
+                break;
+            }
+
+            submitDrawList();
+            ++frames;
+        }
+
+        delete m_pRenderThread;
+        m_pRenderThread = nullptr;
+
+        const double seconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+        std::cout << "[INFO] Replayed " << frames << " frames in " << seconds << " s ("
+                  << (seconds > 0.0 ? frames / seconds : 0.0) << " fps)" << std::endl;
+
+        for (utils::interfaces::ISprite * p_sprite : sprites)
+        {
+            if (p_sprite != nullptr)
+            {
+                destroySprite(p_sprite);
+            }
+        }
+
+        spriteDeferredDestruction();
+        p_platform->destroy();
+
+        return ret_value;
+    }
+
     utils::interfaces::IGraphicContainer * CFramework::window() const { return m_pWindow; }
 
+    utils::interfaces::ISprite * CFramework::createSprite(const char * imagePath)
+    {
+        assert(imagePath && imagePath[0]);
+
+        auto it = m_spriteCache.find(imagePath);
+        if (it == m_spriteCache.end())
+        {
+            utils::interfaces::IPlatform * p_platform = platform();
+            assert(p_platform);
+
+            utils::interfaces::ISprite * p_sprite = p_platform->createSprite(imagePath);
+            if (p_sprite == nullptr)
+            {
+                return nullptr;
+            }
+
+            if (m_drawTrace.isOpen())
+            {
+                m_drawTrace.defineSprite(p_sprite, imagePath);
+            }
+
+            SSpriteReference reference;
+            reference.pSprite = p_sprite;
+            it = m_spriteCache.insert(std::make_pair(std::string(imagePath), reference)).first;
+            m_spriteImages[p_sprite] = it;
+        }
+
+        ++it->second.references;
+        return it->second.pSprite;
+    }
+
     void CFramework::destroySprite(utils::interfaces::ISprite * pSprite)
     {
         assert(pSprite);
+
+        auto it = m_spriteImages.find(pSprite);
+        if (it != m_spriteImages.end())
+        {
+            SSpriteReference & reference = it->second->second;
+            assert(reference.references > 0);
+            if (--reference.references > 0)
+            {
+                return;
+            }
+        }
+
         utils::containers::gPushBackUnique(m_sprites, pSprite);
     }
 
+    CSlabPool & CFramework::itemPool(graphic::CGraphicItem::item_type type)
+    {
+        switch (type)
+        {
+            case graphic::CGraphicItem::item_type::bitmap:
+                return m_bitmapPool;
+
+            case graphic::CGraphicItem::item_type::textfield:
+                return m_textfieldPool;
+
+            default:
+                assert(type == graphic::CGraphicItem::item_type::container);
+                return m_containerPool;
+        }
+    }
+
     utils::interfaces::IVariablesManager * CFramework::variablesManager() const
     {
         return m_pVariablesManager;
     }
 
+    bool CFramework::packPictures(utils::CPicture * const pPictures[], size_t count)
+    {
+        assert(pPictures);
+
+        utils::CTextureAtlas atlas;
+        std::map<std::string, size_t> image_indices;
+        std::vector<size_t> picture_images(count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            assert(pPictures[i]);
+            const std::string image_path = pPictures[i]->image();
+
+            auto it = image_indices.find(image_path);
+            if (it == image_indices.end())
+            {
+                utils::CBitmapImage image;
+                const std::string path = utils::path_utils::executablePath() + "/" + image_path;
+                if (!image.load(path.c_str()))
+                {
+                    std::cerr << "[ERROR] Image " << path.c_str() << " cannot be packed"
+                              << std::endl;
+                    return false;
+                }
+
+                it = image_indices.insert(std::make_pair(image_path, atlas.addImage(image))).first;
+            }
+
+            picture_images[i] = it->second;
+        }
+
+        if (!packAtlas(atlas))
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            pPictures[i]->setAtlasRectangle(atlas.rectangle(picture_images[i]));
+        }
+
+        return true;
+    }
+
+    bool CFramework::packAtlas(utils::CTextureAtlas & atlas)
+    {
+        const size_t glyph_image = atlas.addImage(graphic::CGlyphAtlas::image());
+        if (!atlas.pack())
+        {
+            std::cerr << "[ERROR] Images do not fit in the texture atlas" << std::endl;
+            return false;
+        }
+
+        m_atlas = atlas.image();
+
+        // Only the platforms accepting the atlas can copy the glyphs from it
+        utils::interfaces::IPlatformBatch * p_batch = m_pPlatformManager->batch();
+        const bool atlas_accepted = (p_batch != nullptr) && p_batch->setAtlas(m_atlas);
+        m_glyphAtlas.setAtlasRectangle(atlas_accepted ? atlas.rectangle(glyph_image)
+                                                      : utils::CRectangle());
+
+        return true;
+    }
+
+    void CFramework::destroyWindowItems()
+    {
+        if (m_pWindow == nullptr)
+        {
+            return;
+        }
+
+        while (m_pWindow->childCount() > 0)
+        {
+            delete m_pWindow->child(m_pWindow->childCount() - 1);
+        }
+    }
+
     void CFramework::spriteDeferredDestruction()
     {
         auto it_end = m_sprites.end();
         for (auto it = m_sprites.begin(); it != it_end; ++it)
         {
+            // Sprites asked again since they were released are kept
+            auto it_image = m_spriteImages.find(*it);
+            if (it_image != m_spriteImages.end())
+            {
+                if (it_image->second->second.references > 0)
+                {
+                    continue;
+                }
+
+                m_spriteCache.erase(it_image->second);
+                m_spriteImages.erase(it_image);
+            }
+
             (*it)->destroy();
         }
 
         m_sprites.clear();
     }
 
+    void CFramework::acquireDrawList()
+    {
+        if (m_pRenderThread != nullptr)
+        {
+            m_pDrawList = &m_pRenderThread->acquire();
+        }
+    }
+
+    void CFramework::submitDrawList()
+    {
+        // The first list, and all of them without tracking, redraw the whole window
+        graphic::CGraphicItem::flushDamage(*m_pDrawList);
+        m_pDrawList->setFullRedraw(m_fullRedraw);
+        m_fullRedraw = !m_damageTracking;
+
+        if (m_drawTrace.isOpen())
+        {
+            m_drawTrace.writeFrame(*m_pDrawList);
+        }
+
+        if (m_pRenderThread != nullptr)
+        {
+            // The queued list belongs to the render thread until acquired again
+            m_pRenderThread->submit(*m_pDrawList);
+            m_pDrawList = &m_drawList;
+            return;
+        }
+
+        utils::interfaces::IPlatformBatch * p_batch = m_pPlatformManager->batch();
+        if (p_batch != nullptr)
+        {
+            p_batch->submit(m_drawList);
+        }
+        else
+        {
+            m_drawList.replay(m_pPlatformManager->platform());
+        }
+
+        m_drawList.clear();
+    }
+
     void CFramework::onUpdate(float deltaTime)
     {
         for (auto & m_listener : m_listeners)
@@ -264,7 +669,7 @@ namespace engine {
     {
         m_pVariablesManager = new CVariablesManager();
 
-        std::string system_file = utils::path_utils::executablePath() + "\\system.csv";
+        std::string system_file = utils::path_utils::executablePath() + "/system.csv";
         if (!m_pVariablesManager->loadConfig(system_file.c_str()))
         {
             std::cerr << "[ERROR] Variables manager cannot load file " << system_file.c_str()
@@ -272,7 +677,7 @@ namespace engine {
             return false;
         }
 
-        std::string variables_file = utils::path_utils::executablePath() + "\\variables.csv";
+        std::string variables_file = utils::path_utils::executablePath() + "/variables.csv";
         if (!m_pVariablesManager->loadConfig(variables_file.c_str()))
         {
             std::cerr << "[ERROR] Variables manager cannot load file " << variables_file.c_str()
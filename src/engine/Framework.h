@@ -18,12 +18,23 @@
 ****************************************************************************************/
 
 #pragma once
+#include "GlyphAtlas.h"
+#include "GraphicItem.h"
+#include "SlabPool.h"
+#include <BitmapImage.h>
+#include <DrawList.h>
+#include <DrawTrace.h>
 #include <IFramework.h>
 #include <IGame.h>
 #include <IPlatform.h>
 #include <IPlatformManager.h>
+#include <map>
+#include <string>
+#include <unordered_map>
 
 namespace utils {
+	class CTextureAtlas;
+
 	namespace interfaces {
 		struct ISprite;
 	}
@@ -31,6 +42,7 @@ namespace utils {
 
 namespace engine {
 
+	class CRenderThread;
 	class CVariablesManager;
 
 	namespace graphic {
@@ -56,19 +68,56 @@ namespace engine {
 		utils::interfaces::IPlatform * platform();
 
 		/**
-		* @brief Schedules a sprite to be destroyed
+		* @brief Retrieves the sprite of the given image. All the users of an image share the same
+		* sprite, which must be released with destroySprite. Returns nullptr if the platform cannot
+		* create the sprite
+		*/
+		utils::interfaces::ISprite * createSprite(const char * imagePath);
+
+		/**
+		* @brief Releases a sprite. The sprite is scheduled to be destroyed once all its users have
+		* released it, and revived if the image is asked again before the destruction
 		*/
 		void destroySprite(utils::interfaces::ISprite * pSprite);
 
+		/**
+		* @brief Retrieves the pool the items of the given type are allocated from, so the scene
+		* nodes created and deleted during the game reuse the same memory. There is one pool for
+		* the bitmaps, one for the textfields and one for the containers
+		*/
+		CSlabPool & itemPool(graphic::CGraphicItem::item_type type);
+
+		/**
+		* @brief Retrieves the list the items draw into during the paint of the frame. With a render
+		* thread, each frame gets another list
+		*/
+		inline utils::CDrawList & drawList() { return *m_pDrawList; }
+
+		/**
+		* @brief Retrieves the texture atlas of the pictures packed by the game and of the glyphs
+		*/
+		inline const utils::CBitmapImage & atlas() const { return m_atlas; }
+
+		/**
+		* @brief Retrieves the glyphs of the texts in the texture atlas. Returns nullptr if the
+		* platform does not draw from the atlas, the texts are then drawn by the platform itself
+		*/
+		inline const graphic::CGlyphAtlas * glyphAtlas() const
+		{
+			return m_glyphAtlas.isValid() ? &m_glyphAtlas : nullptr;
+		}
+
 	public:
 		// IFramework
 		bool init() override;
 		int exec() override;
+		int replay(const char * tracePath) override;
 		utils::interfaces::IGraphicContainer * window() const override;
 		inline float elapsedTime() const override { return m_time; }
 		inline unsigned int random(size_t maxValue) const override { return rand() % maxValue; }
 		inline const char * applicationPath() const override { return m_applicationPath.c_str(); }
 		utils::interfaces::IVariablesManager * variablesManager() const override;
+		bool packPictures(utils::CPicture * const pPictures[], size_t count) override;
 		//~IFramework
 
 
@@ -81,6 +130,33 @@ namespace engine {
 
 	private:
 		void spriteDeferredDestruction();
+
+		/**
+		* @brief Retrieves the list the next paint draws into
+		*/
+		void acquireDrawList();
+
+		/**
+		* @brief Hands the draw list of the frame to the platform, in one call when the platform
+		* supports it, and empties it. The list carries the damage of the frame when the
+		* sys_damageTracking variable is set, otherwise it asks for a full redraw.
+		* With a render thread, the list is queued and the platform draws it while the next frame
+		* is simulated
+		*/
+		void submitDrawList();
+
+		/**
+		* @brief Packs the images added to the atlas with the glyphs of the texts and hands the
+		* atlas to the platform. Returns false if the images do not fit in the atlas
+		*/
+		bool packAtlas(utils::CTextureAtlas & atlas);
+
+		/**
+		* @brief Deletes the items left in the window. Their sprites and the images the game library
+		* shared with them must be released before the platform and the library go away
+		*/
+		void destroyWindowItems();
+
 		void makeApplicationPath();
 
 		bool initVariables();
@@ -93,6 +169,29 @@ namespace engine {
 		typedef std::vector<utils::interfaces::ISprite *> TSprites;
 		TSprites m_sprites;
 
+		struct SSpriteReference
+		{
+			utils::interfaces::ISprite * pSprite{ nullptr };
+			unsigned int references{ 0 };
+		};
+
+		typedef std::map<std::string, SSpriteReference> TSpriteCache;
+		TSpriteCache m_spriteCache; /* Sprite of each image path */
+		std::unordered_map<utils::interfaces::ISprite *, TSpriteCache::iterator> m_spriteImages;
+
+		utils::CDrawList m_drawList;
+		utils::CDrawList * m_pDrawList{ &m_drawList }; /* List of the current frame */
+		utils::CDrawTraceWriter m_drawTrace;
+		CRenderThread * m_pRenderThread{ nullptr };
+		bool m_damageTracking{ false };
+		bool m_fullRedraw{ true }; /* Next draw list must redraw the whole window */
+		utils::CBitmapImage m_atlas;
+		graphic::CGlyphAtlas m_glyphAtlas;
+
+		CSlabPool m_bitmapPool;
+		CSlabPool m_textfieldPool;
+		CSlabPool m_containerPool;
+
 		float m_time{ 0.0f };
 
 		utils::interfaces::CInputKey m_keyFire{ utils::interfaces::CInputKey::key::fire };
@@ -0,0 +1,107 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#include "GlyphAtlas.h"
+#include <BitmapFont.h>
+#include <cassert>
+
+namespace engine {
+    namespace graphic {
+
+        static const std::uint32_t glyph_color = 0xFFFFFFFFu;
+
+        utils::CBitmapImage CGlyphAtlas::image()
+        {
+            utils::CBitmapImage image(utils::CBitmapFont::glyph_count * utils::CBitmapFont::advance,
+                                      utils::CBitmapFont::glyph_height);
+
+            for (int i = 0; i < utils::CBitmapFont::glyph_count; ++i)
+            {
+                const std::uint8_t * p_glyph =
+                    utils::CBitmapFont::glyph((char)(utils::CBitmapFont::first_glyph + i));
+                const int left = i * utils::CBitmapFont::advance;
+
+                for (int y = 0; y < utils::CBitmapFont::glyph_height; ++y)
+                {
+                    std::uint32_t * p_line = image.scanLine(y) + left;
+                    for (int x = 0; x < utils::CBitmapFont::glyph_width; ++x)
+                    {
+                        if (p_glyph[y] & (0x10 >> x))
+                        {
+                            p_line[x] = glyph_color;
+                        }
+                    }
+                }
+            }
+
+            return image;
+        }
+
+        void CGlyphAtlas::layout(const char * text, TQuads & quads)
+        {
+            assert(text);
+
+            quads.clear();
+
+            SQuad quad;
+            for (const char * p_char = text; *p_char != '\0'; ++p_char)
+            {
+                if (*p_char == '\n')
+                {
+                    quad.x = 0;
+                    quad.y += utils::CBitmapFont::line_height;
+                    continue;
+                }
+
+                quad.character = *p_char;
+                if ((quad.character < utils::CBitmapFont::first_glyph) ||
+                    (quad.character > utils::CBitmapFont::last_glyph))
+                {
+                    quad.character = '?';
+                }
+
+                const std::uint8_t * p_glyph = utils::CBitmapFont::glyph(quad.character);
+                for (int y = 0; y < utils::CBitmapFont::glyph_height; ++y)
+                {
+                    if (p_glyph[y] != 0)
+                    {
+                        quads.push_back(quad);
+                        break;
+                    }
+                }
+
+                quad.x += utils::CBitmapFont::advance;
+            }
+        }
+
+        utils::CRectangle CGlyphAtlas::glyphRectangle(char c) const
+        {
+            assert(isValid());
+            assert((c >= utils::CBitmapFont::first_glyph) &&
+                   (c <= utils::CBitmapFont::last_glyph));
+
+            const int index = c - utils::CBitmapFont::first_glyph;
+            return utils::CRectangle(m_atlasRectangle.x() + index * utils::CBitmapFont::advance,
+                                     m_atlasRectangle.y(),
+                                     utils::CBitmapFont::glyph_width,
+                                     utils::CBitmapFont::glyph_height);
+        }
+
+    } // namespace graphic
+} // namespace engine
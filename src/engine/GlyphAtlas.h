@@ -0,0 +1,85 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#pragma once
+#include <BitmapImage.h>
+#include <Rectangle.h>
+#include <vector>
+
+namespace engine {
+    namespace graphic {
+
+        /**
+         * @brief CGlyphAtlas lays the glyphs of CBitmapFont side by side in an image, which the
+         * framework packs in the texture atlas with the pictures. The texts can then be drawn as
+         * copies of their glyphs from the atlas, batched like the sprites. The glyphs are white on
+         * transparent, the color of the texts drawn by the platforms
+         */
+        class CGlyphAtlas final
+        {
+          public:
+            /**
+             * @brief Glyph of a laid-out text, at an offset from the position of the text
+             */
+            struct SQuad
+            {
+                int x{0};
+                int y{0};
+                char character{'\0'};
+            };
+
+            typedef std::vector<SQuad> TQuads;
+
+          public:
+            CGlyphAtlas() = default;
+
+            /**
+             * @brief Returns the image holding all the glyphs, to be added to the texture atlas
+             */
+            static utils::CBitmapImage image();
+
+            /**
+             * @brief Lays out the glyphs of a text, which may span several lines separated by
+             * '\n'. The blank glyphs are left out and the characters without a glyph become '?'
+             */
+            static void layout(const char * text, TQuads & quads);
+
+            /**
+             * @brief Sets the rectangle of image() in the texture atlas. An empty rectangle means
+             * the platform does not draw from the atlas
+             */
+            void setAtlasRectangle(const utils::CRectangle & rectangle)
+            {
+                m_atlasRectangle = rectangle;
+            }
+
+            bool isValid() const { return m_atlasRectangle.isValid(); }
+
+            /**
+             * @brief Returns the rectangle of the glyph of a laid-out character in the texture
+             * atlas
+             */
+            utils::CRectangle glyphRectangle(char c) const;
+
+          private:
+            utils::CRectangle m_atlasRectangle;
+        };
+
+    } // namespace graphic
+} // namespace engine
@@ -28,18 +28,17 @@ namespace engine {
 	namespace graphic {
 
 		CGraphicBitmap::CGraphicBitmap(const utils::CPicture & picture, CGraphicItem * pParent)
-			:CGraphicItem(pParent)
+			:CGraphicItem(pParent, item_type::bitmap)
 			,m_shape(picture.shape())
+			,m_atlasRectangle(picture.atlasRectangle())
+			,m_pOpacityMask(picture.opacityMask())
 		{
 			assert(picture.isValid());
 
 			auto * p_framework = static_cast<CFramework*>(g_env->pFramework);
 			assert(p_framework);
 
-			utils::interfaces::IPlatform * p_platform = p_framework->platform();
-			assert(p_platform);
-
-			m_pSprite = p_platform->createSprite(picture.image());
+			m_pSprite = p_framework->createSprite(picture.image());
 			assert(m_pSprite);
 
 			setPosition(0, 0);
@@ -55,9 +54,27 @@ namespace engine {
 			p_framework->destroySprite(m_pSprite);
 		}
 
+		void * CGraphicBitmap::operator new(size_t size)
+		{
+			auto * p_framework = static_cast<CFramework*>(g_env->pFramework);
+			assert(p_framework);
+			assert(size <= p_framework->itemPool(item_type::bitmap).blockSize());
+
+			return p_framework->itemPool(item_type::bitmap).allocate();
+		}
+
+		void CGraphicBitmap::operator delete(void * pBitmap)
+		{
+			auto * p_framework = static_cast<CFramework*>(g_env->pFramework);
+			assert(p_framework);
+
+			p_framework->itemPool(item_type::bitmap).release(pBitmap);
+		}
+
 		void CGraphicBitmap::draw(int x, int y)
 		{
-			m_pSprite->draw(x, y);
+			auto * p_framework = static_cast<CFramework*>(g_env->pFramework);
+			p_framework->drawList().addSprite(m_pSprite, x, y, m_atlasRectangle);
 		}
 
 	} // namespace graphic
@@ -39,8 +39,15 @@ namespace engine {
 			CGraphicBitmap &operator=(const CGraphicBitmap &) = delete;
 			virtual ~CGraphicBitmap() override;
 
+			/**
+			 * @brief The bitmaps are allocated from a pool of the framework
+			 */
+			static void * operator new(size_t size);
+			static void operator delete(void * pBitmap);
+
 			// CGraphicItem
 			utils::CRectangle shape() const override { return m_shape.translated(position()); }
+			const utils::COpacityMask * opacityMask() const override { return m_pOpacityMask.get(); }
 			//~CGraphicItem
 
 		protected:
@@ -51,6 +58,8 @@ namespace engine {
 		private:
 			utils::interfaces::ISprite * m_pSprite{ nullptr };
 			utils::CRectangle m_shape;
+			utils::CRectangle m_atlasRectangle;
+			std::shared_ptr<const utils::COpacityMask> m_pOpacityMask;
 		};
 
 	} // namespace graphic
@@ -0,0 +1,64 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#pragma once
+#include <Rectangle.h>
+#include <utility>
+#include <vector>
+
+namespace engine {
+    namespace graphic {
+
+        class CGraphicItem;
+
+        /**
+         * @brief CGraphicBroadphase is the spatial index a CGraphicItem may keep over its
+         * children, so collision queries only run the exact shape test on the children close to
+         * the query. Coordinates are expressed in the local space of the owning item (the same
+         * space of the children shapes)
+         */
+        class CGraphicBroadphase
+        {
+          public:
+            typedef std::vector<CGraphicItem *> TItems;
+            typedef std::vector<std::pair<CGraphicItem *, CGraphicItem *>> TItemsPairs;
+
+          public:
+            CGraphicBroadphase() = default;
+            CGraphicBroadphase(const CGraphicBroadphase &) = delete;
+            CGraphicBroadphase & operator=(const CGraphicBroadphase &) = delete;
+            virtual ~CGraphicBroadphase() {}
+
+            virtual void insert(CGraphicItem * pItem) = 0;
+            virtual void remove(CGraphicItem * pItem) = 0;
+
+            /**
+             * @brief Must be called every time the shape of an indexed item changes
+             */
+            virtual void update(CGraphicItem * pItem) = 0;
+
+            /**
+             * @brief Appends to candidates every item which may overlap the given rectangle. Each
+             * item is reported once; the caller is in charge of the exact shape test
+             */
+            virtual void query(const utils::CRectangle & rectangle, TItems & candidates) const = 0;
+        };
+
+    } // namespace graphic
+} // namespace engine
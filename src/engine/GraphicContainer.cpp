@@ -17,14 +17,44 @@
 **
 ****************************************************************************************/
 
+#include "Framework.h"
 #include "GraphicContainer.h"
+#include "GraphicGrid.h"
 #include "GraphicItem.h"
+#include "GraphicSweepAndPrune.h"
+#include <algorithm>
 #include <cassert>
+#include <functional>
+
+#include "ISystemGlobalEnvironment.h"
+extern utils::interfaces::SSystemGlobalEnvironment * g_env;
 
 namespace engine {
     namespace graphic {
 
-        CGraphicContainer::CGraphicContainer(CGraphicItem * pParent) : CGraphicItem(pParent) {}
+        static const unsigned int default_grid_cell_size = 64;
+
+        CGraphicContainer::CGraphicContainer(CGraphicItem * pParent)
+            : CGraphicItem(pParent, item_type::container)
+        {
+        }
+
+        void * CGraphicContainer::operator new(size_t size)
+        {
+            auto * p_framework = static_cast<CFramework *>(g_env->pFramework);
+            assert(p_framework);
+            assert(size <= p_framework->itemPool(item_type::container).blockSize());
+
+            return p_framework->itemPool(item_type::container).allocate();
+        }
+
+        void CGraphicContainer::operator delete(void * pContainer)
+        {
+            auto * p_framework = static_cast<CFramework *>(g_env->pFramework);
+            assert(p_framework);
+
+            p_framework->itemPool(item_type::container).release(pContainer);
+        }
 
         utils::interfaces::IGraphicTextfield * CGraphicContainer::addTextfield(const char * text)
         {
@@ -39,16 +69,339 @@ namespace engine {
         void CGraphicContainer::removeItem(IGraphicItem * pItem)
         {
             assert(pItem);
+
+            // The only conversion of an item handed back by the game: the engine items derive
+            // virtually from the interface, so only the run-time type can find them
             dynamic_cast<CGraphicItem *>(pItem)->setParent(nullptr);
         }
 
+        void CGraphicContainer::setBroadphase(broadphase_mode mode)
+        {
+            switch (mode)
+            {
+                case broadphase_mode::brute_force:
+                    setBroadphaseIndex(nullptr);
+                    break;
+
+                case broadphase_mode::uniform_grid:
+                {
+                    unsigned int cell_size = default_grid_cell_size;
+
+                    utils::interfaces::IVariable * p_variable =
+                        g_env->pFramework->variablesManager()->variable("sys_gridCellSize");
+                    if ((p_variable != nullptr) && (p_variable->value<unsigned int>() > 0))
+                    {
+                        cell_size = p_variable->value<unsigned int>();
+                    }
+
+                    setBroadphaseIndex(new CGraphicGrid(cell_size));
+                }
+                break;
+
+                case broadphase_mode::sweep_and_prune:
+                    setBroadphaseIndex(new CGraphicSweepAndPrune());
+                    break;
+            }
+
+            m_broadphase = mode;
+        }
+
+        void CGraphicContainer::collidingPairs(const TGraphicItems & items,
+                                               const TGraphicItems & others,
+                                               TGraphicItemsPairs & pairs,
+                                               collision_mode mode) const
+        {
+            pairs.clear();
+
+            sweepEntries(items, m_sweepItems, mode);
+            sweepEntries(others, m_sweepOthers, mode);
+
+            // Sort and sweep along the x axis: the entry with the lowest left side is tested
+            // against every entry of the other set starting before its right side
+            const size_t items_size = m_sweepItems.size();
+            const size_t others_size = m_sweepOthers.size();
+            size_t item = 0;
+            size_t other = 0;
+
+            while (item < items_size && other < others_size)
+            {
+                if (m_sweepItems[item].left < m_sweepOthers[other].left)
+                {
+                    const SSweepEntry & entry = m_sweepItems[item];
+                    for (size_t k = other;
+                         k < others_size && m_sweepOthers[k].left <= entry.right;
+                         ++k)
+                    {
+                        IGraphicItem * p_other = m_sweepOthers[k].pItem;
+                        if (p_other != entry.pItem &&
+                            (entry.mask & m_sweepOthers[k].category) != 0 &&
+                            entry.pItem->collidesWithItem(p_other, mode))
+                        {
+                            pairs.push_back(TGraphicItemsPair(entry.pItem, p_other));
+                        }
+                    }
+
+                    ++item;
+                }
+                else
+                {
+                    const SSweepEntry & entry = m_sweepOthers[other];
+                    for (size_t k = item; k < items_size && m_sweepItems[k].left <= entry.right;
+                         ++k)
+                    {
+                        IGraphicItem * p_item = m_sweepItems[k].pItem;
+                        if (p_item != entry.pItem &&
+                            (m_sweepItems[k].mask & entry.category) != 0 &&
+                            p_item->collidesWithItem(entry.pItem, mode))
+                        {
+                            pairs.push_back(TGraphicItemsPair(p_item, entry.pItem));
+                        }
+                    }
+
+                    ++other;
+                }
+            }
+        }
+
+        void CGraphicContainer::sweepEntries(const TGraphicItems & items,
+                                             TSweepEntries & entries,
+                                             collision_mode mode)
+        {
+            entries.clear();
+
+            auto it_end = items.end();
+            for (auto it = items.begin(); it != it_end; ++it)
+            {
+                IGraphicItem * p_item = (*it);
+                if (p_item == nullptr)
+                {
+                    continue;
+                }
+
+                const utils::CRectangle shape =
+                    mode == collision_mode::swept_intersect
+                        ? sweptRectangle(p_item->sceneShape(),
+                                         p_item->position() - p_item->previousPosition())
+                        : p_item->sceneShape();
+                const double left = shape.x();
+                const double right = std::max(left, left + shape.width());
+
+                SSweepEntry entry = {
+                    left, right, p_item, p_item->collisionCategory(), p_item->collisionMask()};
+                entries.push_back(entry);
+            }
+
+            std::sort(entries.begin(), entries.end());
+        }
+
+        void CGraphicContainer::updateContacts()
+        {
+            if (!m_listeners.empty())
+            {
+                if (m_broadphase == broadphase_mode::sweep_and_prune)
+                {
+                    // The sorted list is kept between frames, so the overlapping pairs are found
+                    // without sorting the children again
+                    m_contactCandidates.clear();
+                    static_cast<const CGraphicSweepAndPrune *>(broadphaseIndex())
+                        ->pairs(m_contactCandidates);
+
+                    m_contactsFound.clear();
+                    auto it_end = m_contactCandidates.end();
+                    for (auto it = m_contactCandidates.begin(); it != it_end; ++it)
+                    {
+                        CGraphicItem * p_item = it->first;
+                        CGraphicItem * p_other = it->second;
+                        if ((p_item->collisionMask() & p_other->collisionCategory()) != 0 &&
+                            p_item->collidesWithItem(p_other, collision_mode::swept_intersect))
+                        {
+                            m_contactsFound.push_back(TGraphicItemsPair(p_item, p_other));
+                        }
+
+                        if ((p_other->collisionMask() & p_item->collisionCategory()) != 0 &&
+                            p_other->collidesWithItem(p_item, collision_mode::swept_intersect))
+                        {
+                            m_contactsFound.push_back(TGraphicItemsPair(p_other, p_item));
+                        }
+                    }
+                }
+                else
+                {
+                    collidingPairs(
+                        items(), items(), m_contactsFound, collision_mode::swept_intersect);
+                }
+
+                // Mutual matches are found in both orders, only one of them is kept
+
+                auto it_found_end = std::remove_if(
+                    m_contactsFound.begin(),
+                    m_contactsFound.end(),
+                    [](const TGraphicItemsPair & contact) {
+                        return (contact.second->collisionMask() &
+                                contact.first->collisionCategory()) != 0 &&
+                               std::less<IGraphicItem *>()(contact.second, contact.first);
+                    });
+                m_contactsFound.erase(it_found_end, m_contactsFound.end());
+                std::sort(m_contactsFound.begin(), m_contactsFound.end());
+
+                // Both lists are sorted, so a single merge finds the contacts which started and
+                // the ones which ended
+                m_contactEvents.clear();
+
+                size_t found = 0;
+                size_t previous = 0;
+                while (found < m_contactsFound.size() || previous < m_contacts.size())
+                {
+                    if (previous == m_contacts.size() ||
+                        (found < m_contactsFound.size() &&
+                         m_contactsFound[found] < m_contacts[previous]))
+                    {
+                        const TGraphicItemsPair & contact = m_contactsFound[found++];
+                        SContactEvent event = {contact.first, contact.second, true};
+                        m_contactEvents.push_back(event);
+                    }
+                    else if (found == m_contactsFound.size() ||
+                             m_contacts[previous] < m_contactsFound[found])
+                    {
+                        const TGraphicItemsPair & contact = m_contacts[previous++];
+                        SContactEvent event = {contact.first, contact.second, false};
+                        m_contactEvents.push_back(event);
+                    }
+                    else
+                    {
+                        ++found;
+                        ++previous;
+                    }
+                }
+
+                m_contacts.swap(m_contactsFound);
+
+                // Listeners may remove items, which clears their pending events in childRemoved
+                for (size_t i = 0; i < m_contactEvents.size(); ++i)
+                {
+                    const SContactEvent event = m_contactEvents[i];
+                    if (event.pItem == nullptr)
+                    {
+                        continue;
+                    }
+
+                    if (event.begin)
+                    {
+                        onContactBegin(event.pItem, event.pOther);
+                    }
+                    else
+                    {
+                        onContactEnd(event.pItem, event.pOther);
+                    }
+                }
+
+                m_contactEvents.clear();
+            }
+            else if (!m_contacts.empty())
+            {
+                m_contacts.clear();
+            }
+
+            for (size_t i = 0; i < childCount(); ++i)
+            {
+                CGraphicItem * p_child = child(i);
+                if (p_child->itemType() == item_type::container)
+                {
+                    static_cast<CGraphicContainer *>(p_child)->updateContacts();
+                }
+            }
+        }
+
+        void CGraphicContainer::childRemoved(CGraphicItem * pChild)
+        {
+            const IGraphicItem * p_child = pChild;
+
+            auto it_end = std::remove_if(m_contacts.begin(),
+                                         m_contacts.end(),
+                                         [p_child](const TGraphicItemsPair & contact) {
+                                             return contact.first == p_child ||
+                                                    contact.second == p_child;
+                                         });
+            m_contacts.erase(it_end, m_contacts.end());
+
+            auto it_events_end = m_contactEvents.end();
+            for (auto it = m_contactEvents.begin(); it != it_events_end; ++it)
+            {
+                if (it->pItem == p_child || it->pOther == p_child)
+                {
+                    it->pItem = nullptr;
+                    it->pOther = nullptr;
+                }
+            }
+        }
+
+        void CGraphicContainer::onContactBegin(IGraphicItem * pItem, IGraphicItem * pOther)
+        {
+            for (size_t i = 0; i < m_listeners.size(); ++i)
+            {
+                m_listeners[i]->onContactBegin(pItem, pOther);
+            }
+        }
+
+        void CGraphicContainer::onContactEnd(IGraphicItem * pItem, IGraphicItem * pOther)
+        {
+            for (size_t i = 0; i < m_listeners.size(); ++i)
+            {
+                m_listeners[i]->onContactEnd(pItem, pOther);
+            }
+        }
+
         void CGraphicContainer::paint()
         {
-            const TGraphicItems & graphic_items = items();
-            auto it_end = graphic_items.end();
-            for (auto it = graphic_items.begin(); it != it_end; ++it)
+            // The root of the tree is the window, nothing outside of its shape can be seen
+            const IGraphicItem * p_root = this;
+            while (p_root->parent() != nullptr)
             {
-                dynamic_cast<CGraphicItem *>(*it)->paint();
+                p_root = p_root->parent();
+            }
+
+            utils::CRectangle visible = p_root->sceneShape().translated(-scenePosition());
+
+            // Neither are the items lying outside of the container, when it has a size
+            if (!size().isEmpty())
+            {
+                visible = visible.intersected(utils::CRectangle(utils::CPoint(0, 0), size()));
+            }
+
+            if (visible.width() < 0 || visible.height() < 0)
+            {
+                return;
+            }
+
+            const TPaintOrder & paint_order = paintOrder();
+            auto it_end = paint_order.end();
+            for (auto it = paint_order.begin(); it != it_end; ++it)
+            {
+                CGraphicItem * p_item = *it;
+                if (p_item == nullptr)
+                {
+                    continue;
+                }
+
+                // Items without a size, such as the text fields, have no known extent and can
+                // only be culled through their children
+                utils::CRectangle bounds = p_item->boundingRectangle();
+                if (!p_item->size().isEmpty())
+                {
+                    bounds = bounds.united(p_item->rectangle());
+                }
+                else if (p_item->items().empty())
+                {
+                    p_item->paint();
+                    continue;
+                }
+
+                if (!touches(bounds, visible))
+                {
+                    continue;
+                }
+
+                p_item->paint();
             }
         }
 
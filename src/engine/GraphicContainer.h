@@ -19,6 +19,7 @@
 
 #pragma once
 #include "GraphicBitmap.h"
+#include "GraphicBroadphase.h"
 #include "GraphicItem.h"
 #include "GraphicTextfield.h"
 #include <IGraphicContainer.h>
@@ -34,8 +35,21 @@ namespace engine {
 			CGraphicContainer &operator=(const CGraphicContainer &) = delete;
 			virtual ~CGraphicContainer() override {};
 
+			/**
+			 * @brief The containers are allocated from a pool of the framework
+			 */
+			static void * operator new(size_t size);
+			static void operator delete(void * pContainer);
+
+			/**
+			 * @brief Updates the contacts between the children of the container and of all the nested containers,
+			 * then notifies the contact listeners of the contacts which started or ended since the last update
+			 */
+			void updateContacts();
+
 			// CGraphicItem
 			void paint() override;
+			inline utils::CRectangle paintRectangle() const override { return utils::CRectangle(0, 0, -1, -1); }
 			//~CGraphicItem
 
 			// IGraphicContainer
@@ -43,12 +57,57 @@ namespace engine {
 			inline utils::interfaces::IGraphicBitmap * addBitmap(const utils::CPicture & picture) override { return new CGraphicBitmap(picture, this); }
 			utils::interfaces::IGraphicTextfield * addTextfield(const char * text = nullptr) override;
 			void removeItem(IGraphicItem * pItem) override;
+			void setBroadphase(broadphase_mode mode) override;
+			inline broadphase_mode broadphase() const override { return m_broadphase; }
+			void collidingPairs(const TGraphicItems & items, const TGraphicItems & others, TGraphicItemsPairs & pairs, collision_mode mode = collision_mode::intersect) const override;
 			//~IGraphicContainer
 
 		protected:
 			// CGraphicItem
 			virtual void draw(int x, int y) override {}
+			void childRemoved(CGraphicItem * pChild) override;
 			//~CGraphicItem
+
+			// IGraphicContactListener
+			void onContactBegin(IGraphicItem * pItem, IGraphicItem * pOther) override;
+			void onContactEnd(IGraphicItem * pItem, IGraphicItem * pOther) override;
+			//~IGraphicContactListener
+
+		private:
+			struct SSweepEntry
+			{
+				double left;
+				double right;
+				IGraphicItem * pItem;
+				unsigned int category;
+				unsigned int mask;
+
+				inline bool operator<(const SSweepEntry & other) const { return left < other.left; }
+			};
+
+			typedef std::vector<SSweepEntry> TSweepEntries;
+
+			struct SContactEvent
+			{
+				IGraphicItem * pItem; /* Both set to nullptr when one of the items is removed before the notification */
+				IGraphicItem * pOther;
+				bool begin;
+			};
+
+			typedef std::vector<SContactEvent> TContactEvents;
+
+			static void sweepEntries(const TGraphicItems & items, TSweepEntries & entries, collision_mode mode);
+
+		private:
+			broadphase_mode m_broadphase{ broadphase_mode::brute_force };
+
+			mutable TSweepEntries m_sweepItems; /* Scratch buffers reused by collidingPairs */
+			mutable TSweepEntries m_sweepOthers;
+
+			TGraphicItemsPairs m_contacts; /* Contacts found by the last update, sorted */
+			TGraphicItemsPairs m_contactsFound; /* Scratch buffer of the contacts of the current update */
+			CGraphicBroadphase::TItemsPairs m_contactCandidates; /* Scratch buffer of the sweep and prune pairs */
+			TContactEvents m_contactEvents; /* Notifications pending from the current update */
 		};
 
 	} // namespace graphic
@@ -0,0 +1,220 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#include "GraphicGrid.h"
+#include "GraphicItem.h"
+#include <ContainersUtils.h>
+#include <cassert>
+#include <cmath>
+
+namespace engine {
+    namespace graphic {
+
+        static const int grid_max_cells_per_item = 64;
+
+        CGraphicGrid::CGraphicGrid(double cellSize) : m_cellSize(cellSize)
+        {
+            assert(m_cellSize > 0);
+        }
+
+        void CGraphicGrid::insert(CGraphicItem * pItem)
+        {
+            assert(pItem);
+
+            SEntry & entry = m_entries[pItem];
+            if (entry.pItem != nullptr)
+            {
+                return;
+            }
+
+            entry.pItem = pItem;
+            entry.range = cellRange(pItem->sweptShape());
+            link(&entry);
+        }
+
+        void CGraphicGrid::remove(CGraphicItem * pItem)
+        {
+            assert(pItem);
+
+            auto it = m_entries.find(pItem);
+            if (it == m_entries.end())
+            {
+                return;
+            }
+
+            unlink(&it->second);
+            m_entries.erase(it);
+        }
+
+        void CGraphicGrid::update(CGraphicItem * pItem)
+        {
+            assert(pItem);
+
+            auto it = m_entries.find(pItem);
+            if (it == m_entries.end())
+            {
+                return;
+            }
+
+            SEntry & entry = it->second;
+            SCellRange range = cellRange(pItem->sweptShape());
+            if (range.unbounded == entry.range.unbounded && range.left == entry.range.left &&
+                range.top == entry.range.top && range.right == entry.range.right &&
+                range.bottom == entry.range.bottom)
+            {
+                return;
+            }
+
+            unlink(&entry);
+            entry.range = range;
+            link(&entry);
+        }
+
+        void CGraphicGrid::query(const utils::CRectangle & rectangle, TItems & candidates) const
+        {
+            ++m_stamp;
+
+            auto it_unbounded_end = m_unbounded.end();
+            for (auto it = m_unbounded.begin(); it != it_unbounded_end; ++it)
+            {
+                (*it)->stamp = m_stamp;
+                candidates.push_back((*it)->pItem);
+            }
+
+            if (!rectangle.isValid())
+            {
+                return;
+            }
+
+            const double left = std::floor(rectangle.x() / m_cellSize);
+            const double top = std::floor(rectangle.y() / m_cellSize);
+            const double right = std::floor((rectangle.x() + rectangle.width()) / m_cellSize);
+            const double bottom = std::floor((rectangle.y() + rectangle.height()) / m_cellSize);
+
+            auto visit = [this, &candidates](const TCell & cell) {
+                auto it_end = cell.end();
+                for (auto it = cell.begin(); it != it_end; ++it)
+                {
+                    SEntry * p_entry = (*it);
+                    if (p_entry->stamp != m_stamp)
+                    {
+                        p_entry->stamp = m_stamp;
+                        candidates.push_back(p_entry->pItem);
+                    }
+                }
+            };
+
+            // Large queries (e.g. a container checking its own borders) are cheaper walking the
+            // occupied cells than hashing every cell of the query range
+            if ((right - left + 1) * (bottom - top + 1) > static_cast<double>(m_cells.size()))
+            {
+                auto it_end = m_cells.end();
+                for (auto it = m_cells.begin(); it != it_end; ++it)
+                {
+                    const int column =
+                        static_cast<int>(static_cast<unsigned int>(it->first >> 32));
+                    const int row = static_cast<int>(static_cast<unsigned int>(it->first));
+                    if (column >= left && column <= right && row >= top && row <= bottom)
+                    {
+                        visit(it->second);
+                    }
+                }
+
+                return;
+            }
+
+            for (int column = static_cast<int>(left); column <= static_cast<int>(right); ++column)
+            {
+                for (int row = static_cast<int>(top); row <= static_cast<int>(bottom); ++row)
+                {
+                    auto it = m_cells.find(cellKey(column, row));
+                    if (it != m_cells.end())
+                    {
+                        visit(it->second);
+                    }
+                }
+            }
+        }
+
+        CGraphicGrid::SCellRange CGraphicGrid::cellRange(const utils::CRectangle & rectangle) const
+        {
+            SCellRange range;
+
+            if (!rectangle.isValid())
+            {
+                return range;
+            }
+
+            const double left = std::floor(rectangle.x() / m_cellSize);
+            const double top = std::floor(rectangle.y() / m_cellSize);
+            const double right = std::floor((rectangle.x() + rectangle.width()) / m_cellSize);
+            const double bottom = std::floor((rectangle.y() + rectangle.height()) / m_cellSize);
+
+            if ((right - left + 1) * (bottom - top + 1) > grid_max_cells_per_item)
+            {
+                return range;
+            }
+
+            range.left = static_cast<int>(left);
+            range.top = static_cast<int>(top);
+            range.right = static_cast<int>(right);
+            range.bottom = static_cast<int>(bottom);
+            range.unbounded = false;
+            return range;
+        }
+
+        void CGraphicGrid::link(SEntry * pEntry)
+        {
+            if (pEntry->range.unbounded)
+            {
+                m_unbounded.push_back(pEntry);
+                return;
+            }
+
+            for (int column = pEntry->range.left; column <= pEntry->range.right; ++column)
+            {
+                for (int row = pEntry->range.top; row <= pEntry->range.bottom; ++row)
+                {
+                    m_cells[cellKey(column, row)].push_back(pEntry);
+                }
+            }
+        }
+
+        void CGraphicGrid::unlink(SEntry * pEntry)
+        {
+            if (pEntry->range.unbounded)
+            {
+                utils::containers::gFindAndErase(m_unbounded, pEntry);
+                return;
+            }
+
+            for (int column = pEntry->range.left; column <= pEntry->range.right; ++column)
+            {
+                for (int row = pEntry->range.top; row <= pEntry->range.bottom; ++row)
+                {
+                    // Empty cells are kept to avoid reallocating them while items move around
+                    auto it = m_cells.find(cellKey(column, row));
+                    assert(it != m_cells.end());
+                    utils::containers::gFindAndErase(it->second, pEntry);
+                }
+            }
+        }
+
+    } // namespace graphic
+} // namespace engine
@@ -0,0 +1,98 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#pragma once
+#include "GraphicBroadphase.h"
+#include <unordered_map>
+#include <vector>
+
+namespace engine {
+    namespace graphic {
+
+        /**
+         * @brief CGraphicGrid is a uniform grid spatial hash indexing the children of a
+         * CGraphicItem. Each child is linked to every cell its shape overlaps, so a query only
+         * visits the items stored in the cells overlapped by the query rectangle. Coordinates are
+         * expressed in the local space of the owning item (the same space of the children shapes)
+         */
+        class CGraphicGrid final : public CGraphicBroadphase
+        {
+          public:
+            explicit CGraphicGrid(double cellSize);
+            CGraphicGrid(const CGraphicGrid &) = delete;
+            CGraphicGrid & operator=(const CGraphicGrid &) = delete;
+
+            inline double cellSize() const noexcept { return m_cellSize; }
+
+            // CGraphicBroadphase
+            void insert(CGraphicItem * pItem) override;
+            void remove(CGraphicItem * pItem) override;
+
+            /**
+             * @brief Relinks the item to the cells overlapped by its current shape. Nothing is
+             * done when the item still overlaps the same cells
+             */
+            void update(CGraphicItem * pItem) override;
+
+            void query(const utils::CRectangle & rectangle, TItems & candidates) const override;
+            //~CGraphicBroadphase
+
+          private:
+            struct SCellRange
+            {
+                int left{0};
+                int top{0};
+                int right{-1};
+                int bottom{-1};
+                bool unbounded{true}; /* Items without a valid shape, or spanning too many cells,
+                                         are not linked to cells and reported by every query */
+            };
+
+            struct SEntry
+            {
+                CGraphicItem * pItem{nullptr};
+                SCellRange range;
+                mutable unsigned int stamp{0}; /* Avoids reporting the same item twice per query */
+            };
+
+            typedef std::vector<SEntry *> TCell;
+            typedef std::unordered_map<unsigned long long, TCell> TCells;
+            typedef std::unordered_map<const CGraphicItem *, SEntry> TEntries;
+
+            SCellRange cellRange(const utils::CRectangle & rectangle) const;
+
+            void link(SEntry * pEntry);
+            void unlink(SEntry * pEntry);
+
+            static inline unsigned long long cellKey(int column, int row)
+            {
+                return (static_cast<unsigned long long>(static_cast<unsigned int>(column)) << 32) |
+                       static_cast<unsigned int>(row);
+            }
+
+          private:
+            double m_cellSize{0};
+            TEntries m_entries;
+            TCells m_cells;
+            TCell m_unbounded;
+            mutable unsigned int m_stamp{0};
+        };
+
+    } // namespace graphic
+} // namespace engine
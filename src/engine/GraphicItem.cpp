@@ -17,40 +17,147 @@
 **
 ****************************************************************************************/
 
+#include "GraphicBroadphase.h"
 #include "GraphicItem.h"
-#include <ContainersUtils.h>
+#include "GraphicItemStore.h"
+#include <DrawList.h>
+#include <OpacityMask.h>
+#include <algorithm>
 #include <cassert>
+#include <limits>
 
 namespace engine {
     namespace graphic {
 
-        CGraphicItem::CGraphicItem(CGraphicItem * pParent) { setParent(pParent); }
+        static unsigned int current_frame = 0;
+        static bool damage_tracking = false;
+        static unsigned long long paint_sequence = 0;
+
+        CGraphicItem::CGraphicItem(CGraphicItem * pParent, item_type type) : m_type(type)
+        {
+            detachedStore().insert(this, current_frame);
+            setParent(pParent);
+        }
 
         CGraphicItem::~CGraphicItem()
         {
             if (m_pParent != nullptr)
             {
-                dynamic_cast<CGraphicItem *>(m_pParent)->removeChild(this);
+                m_pParent->removeChild(this);
             }
 
-            TGraphicItems children = m_children;
-            if (children.empty())
+            delete m_pBroadphaseIndex;
+            m_pBroadphaseIndex = nullptr;
+
+            // Deleted from the last painted, so each child leaves the paint order with a pop and
+            // m_children and the store by swapping in their last entry
+            while (!m_paintOrder.empty())
+            {
+                delete m_paintOrder.back();
+            }
+
+            assert(m_children.empty());
+
+            delete m_pChildren;
+            m_pChildren = nullptr;
+
+            m_pStore->erase(m_slot);
+            m_pStore = nullptr;
+        }
+
+        CGraphicItemStore & CGraphicItem::detachedStore()
+        {
+            // Never destroyed, so items deleted during the static destruction still find it
+            static CGraphicItemStore * p_store = new CGraphicItemStore();
+            return *p_store;
+        }
+
+        void CGraphicItem::advanceFrame() { ++current_frame; }
+
+        std::vector<utils::CRectangle> & CGraphicItem::damagedRegions()
+        {
+            // Never destroyed, as detachedStore
+            static std::vector<utils::CRectangle> * p_regions =
+                new std::vector<utils::CRectangle>();
+            return *p_regions;
+        }
+
+        void CGraphicItem::setDamageTracking(bool enabled)
+        {
+            damage_tracking = enabled;
+            damagedRegions().clear();
+        }
+
+        void CGraphicItem::flushDamage(utils::CDrawList & drawList)
+        {
+            std::vector<utils::CRectangle> & regions = damagedRegions();
+            for (const utils::CRectangle & region : regions)
+            {
+                drawList.addDamage(region);
+            }
+
+            regions.clear();
+        }
+
+        void CGraphicItem::damage() const
+        {
+            if (!damage_tracking)
             {
                 return;
             }
 
-            auto it_end = children.end();
-            for (auto it = children.begin(); it != it_end; ++it)
+            const utils::CRectangle bounds = paintBounds();
+            if (bounds.isEmpty())
             {
-                delete *it;
+                return;
+            }
+
+            // One pixel margin, the items are painted at their scene position truncated to integers
+            const utils::CPoint offset =
+                m_pParent != nullptr ? m_pParent->scenePosition() : utils::CPoint();
+            const utils::CRectangle region(bounds.x() + offset.x() - 1,
+                                           bounds.y() + offset.y() - 1,
+                                           bounds.width() + 2,
+                                           bounds.height() + 2);
+
+            // An item set where it already is damages the same region before and after
+            std::vector<utils::CRectangle> & regions = damagedRegions();
+            if (regions.empty() || (regions.back() != region))
+            {
+                regions.push_back(region);
+            }
+        }
+
+        utils::CRectangle CGraphicItem::paintBounds() const
+        {
+            utils::CRectangle bounds = paintRectangle();
+
+            const size_t children_size = m_pChildren != nullptr ? m_pChildren->size() : 0;
+            for (size_t i = 0; i < children_size; ++i)
+            {
+                const utils::CRectangle child_bounds = m_pChildren->item(i)->paintBounds();
+                if (child_bounds.isEmpty())
+                {
+                    continue;
+                }
+
+                const utils::CRectangle translated = child_bounds.translated(position());
+                bounds = bounds.isEmpty() ? translated : bounds.united(translated);
             }
 
-            m_children.clear();
+            return bounds;
         }
 
         utils::interfaces::IGraphicItem * CGraphicItem::parent() const { return m_pParent; }
 
-        void CGraphicItem::setParent(IGraphicItem * pParent)
+        CGraphicItem * CGraphicItem::child(size_t index) const
+        {
+            // The slots of the children in the store follow the order of m_children
+            assert(m_pChildren && (index < m_pChildren->size()));
+            return m_pChildren->item(index);
+        }
+
+        void CGraphicItem::setParent(CGraphicItem * pParent)
         {
             if (m_pParent == pParent)
             {
@@ -59,50 +166,426 @@ namespace engine {
 
             if (m_pParent != nullptr)
             {
-                dynamic_cast<CGraphicItem *>(m_pParent)->removeChild(this);
+                m_pParent->removeChild(this);
             }
 
             m_pParent = pParent;
 
             if (m_pParent != nullptr)
             {
-                dynamic_cast<CGraphicItem *>(m_pParent)->addChild(this);
+                m_pParent->addChild(this);
+            }
+
+            invalidateScene();
+        }
+
+        void CGraphicItem::setLayer(int layer)
+        {
+            if (layer == m_layer)
+            {
+                return;
+            }
+
+            damage();
+
+            if (m_pParent != nullptr)
+            {
+                m_pParent->erasePaintOrder(this);
+            }
+
+            m_layer = layer;
+
+            if (m_pParent != nullptr)
+            {
+                m_pParent->insertPaintOrder(this);
+            }
+
+            damage();
+        }
+
+        void CGraphicItem::setZValue(double z)
+        {
+            if (z == m_zValue)
+            {
+                return;
+            }
+
+            damage();
+
+            if (m_pParent != nullptr)
+            {
+                m_pParent->erasePaintOrder(this);
+            }
+
+            m_zValue = z;
+
+            if (m_pParent != nullptr)
+            {
+                m_pParent->insertPaintOrder(this);
+            }
+
+            damage();
+        }
+
+        bool CGraphicItem::paintsBefore(const CGraphicItem * pItem, const CGraphicItem * pOther)
+        {
+            if (pItem->m_layer != pOther->m_layer)
+            {
+                return pItem->m_layer < pOther->m_layer;
+            }
+
+            if (pItem->m_zValue != pOther->m_zValue)
+            {
+                return pItem->m_zValue < pOther->m_zValue;
+            }
+
+            return pItem->m_paintSequence < pOther->m_paintSequence;
+        }
+
+        void CGraphicItem::insertPaintOrder(CGraphicItem * pChild)
+        {
+            // The children added last sort after the others, so adding one is usually a push
+            if (m_paintOrder.empty() || paintsBefore(m_paintOrder.back(), pChild))
+            {
+                pChild->m_paintIndex = m_paintOrder.size();
+                m_paintOrder.push_back(pChild);
+                return;
+            }
+
+            compactPaintOrder();
+
+            // The sequence makes the keys unique, so the children added last go after their equals
+            auto it = m_paintOrder.insert(
+                std::upper_bound(m_paintOrder.begin(), m_paintOrder.end(), pChild, paintsBefore),
+                pChild);
+
+            for (auto it_end = m_paintOrder.end(); it != it_end; ++it)
+            {
+                (*it)->m_paintIndex = it - m_paintOrder.begin();
+            }
+        }
+
+        void CGraphicItem::erasePaintOrder(CGraphicItem * pChild)
+        {
+            assert(pChild->m_paintIndex < m_paintOrder.size() &&
+                   m_paintOrder[pChild->m_paintIndex] == pChild);
+
+            m_paintOrder[pChild->m_paintIndex] = nullptr;
+            ++m_paintOrderHoles;
+
+            while (!m_paintOrder.empty() && m_paintOrder.back() == nullptr)
+            {
+                m_paintOrder.pop_back();
+                --m_paintOrderHoles;
+            }
+
+            // Compacting once half of the list is holes keeps each removal constant on average
+            if (m_paintOrderHoles * 2 > m_paintOrder.size())
+            {
+                compactPaintOrder();
+            }
+        }
+
+        void CGraphicItem::compactPaintOrder()
+        {
+            if (m_paintOrderHoles == 0)
+            {
+                return;
+            }
+
+            size_t count = 0;
+            const size_t paint_order_size = m_paintOrder.size();
+            for (size_t i = 0; i < paint_order_size; ++i)
+            {
+                CGraphicItem * p_child = m_paintOrder[i];
+                if (p_child != nullptr)
+                {
+                    p_child->m_paintIndex = count;
+                    m_paintOrder[count++] = p_child;
+                }
             }
+
+            m_paintOrder.resize(count);
+            m_paintOrderHoles = 0;
+        }
+
+        utils::CPoint CGraphicItem::position() const { return m_pStore->position(m_slot); }
+
+        utils::CPoint CGraphicItem::previousPosition() const
+        {
+            return m_pStore->previousPosition(m_slot, current_frame);
+        }
+
+        void CGraphicItem::setPosition(const utils::CPoint & position)
+        {
+            damage();
+            m_pStore->beginMove(m_slot, current_frame);
+            m_pStore->setPosition(m_slot, position.x(), position.y());
+            shapeChanged();
+            damage();
+        }
+
+        void CGraphicItem::setPosition(double x, double y)
+        {
+            damage();
+            m_pStore->beginMove(m_slot, current_frame);
+            m_pStore->setPosition(m_slot, x, y);
+            shapeChanged();
+            damage();
         }
 
+        utils::CSize CGraphicItem::size() const { return m_pStore->size(m_slot); }
+
+        void CGraphicItem::setSize(const utils::CSize & size)
+        {
+            damage();
+            m_pStore->setSize(m_slot, size.width(), size.height());
+            shapeChanged();
+            damage();
+        }
+
+        void CGraphicItem::setSize(double w, double h)
+        {
+            damage();
+            m_pStore->setSize(m_slot, w, h);
+            shapeChanged();
+            damage();
+        }
+
+        utils::CRectangle CGraphicItem::rectangle() const { return m_pStore->rectangle(m_slot); }
+
         void CGraphicItem::setRectangle(const utils::CRectangle & rectangle)
         {
-            m_rectangle.setPosition(rectangle.position());
-            m_rectangle.setSize(rectangle.size());
+            damage();
+            m_pStore->beginMove(m_slot, current_frame);
+            m_pStore->setPosition(m_slot, rectangle.x(), rectangle.y());
+            m_pStore->setSize(m_slot, rectangle.width(), rectangle.height());
+            shapeChanged();
+            damage();
         }
 
         void CGraphicItem::setRectangle(double x, double y, double width, double height)
         {
-            m_rectangle.setX(x);
-            m_rectangle.setY(y);
-            m_rectangle.setWidth(width);
-            m_rectangle.setHeight(height);
+            damage();
+            m_pStore->beginMove(m_slot, current_frame);
+            m_pStore->setPosition(m_slot, x, y);
+            m_pStore->setSize(m_slot, width, height);
+            shapeChanged();
+            damage();
+        }
+
+        unsigned int CGraphicItem::collisionCategory() const { return m_pStore->category(m_slot); }
+
+        void CGraphicItem::setCollisionCategory(unsigned int category)
+        {
+            m_pStore->setCategory(m_slot, category);
+        }
+
+        unsigned int CGraphicItem::collisionMask() const { return m_pStore->mask(m_slot); }
+
+        void CGraphicItem::setCollisionMask(unsigned int mask) { m_pStore->setMask(m_slot, mask); }
+
+        void CGraphicItem::shapeChanged()
+        {
+            invalidateScene();
+
+            if (m_pParent == nullptr)
+            {
+                return;
+            }
+
+            m_pParent->invalidateBounds();
+
+            if (m_pParent->m_pBroadphaseIndex != nullptr)
+            {
+                m_pParent->m_pBroadphaseIndex->update(this);
+            }
+        }
+
+        void CGraphicItem::invalidateScene()
+        {
+            if (m_pStore->isSceneDirty(m_slot))
+            {
+                return;
+            }
+
+            m_pStore->setSceneDirty(m_slot);
+
+            if (m_pChildren == nullptr)
+            {
+                return;
+            }
+
+            const size_t children_size = m_pChildren->size();
+            for (size_t i = 0; i < children_size; ++i)
+            {
+                m_pChildren->item(i)->invalidateScene();
+            }
+        }
+
+        void CGraphicItem::updateScene() const
+        {
+            const utils::CPoint offset =
+                m_pParent != nullptr ? m_pParent->scenePosition() : utils::CPoint();
+
+            m_pStore->setScene(m_slot, offset + position(), shape().translated(offset));
+        }
+
+        utils::CPoint CGraphicItem::scenePosition() const
+        {
+            if (m_pStore->isSceneDirty(m_slot))
+            {
+                updateScene();
+            }
+
+            return m_pStore->scenePosition(m_slot);
+        }
+
+        utils::CRectangle CGraphicItem::sceneShape() const
+        {
+            if (m_pStore->isSceneDirty(m_slot))
+            {
+                updateScene();
+            }
+
+            return m_pStore->sceneShape(m_slot);
+        }
+
+        void CGraphicItem::invalidateBounds()
+        {
+            for (CGraphicItem * p_item = this; p_item != nullptr && !p_item->m_childrenBoundsDirty;
+                 p_item = p_item->m_pParent)
+            {
+                p_item->m_childrenBoundsDirty = true;
+            }
+        }
+
+        const utils::CRectangle & CGraphicItem::childrenBounds() const
+        {
+            if (!m_childrenBoundsDirty)
+            {
+                return m_childrenBounds;
+            }
+
+            m_childrenBounds = utils::CRectangle(0, 0, -1, -1);
+
+            const size_t children_size = m_pChildren != nullptr ? m_pChildren->size() : 0;
+            for (size_t i = 0; i < children_size; ++i)
+            {
+                const utils::CRectangle bounds = m_pChildren->item(i)->boundingRectangle();
+                m_childrenBounds = i == 0 ? bounds : m_childrenBounds.united(bounds);
+            }
+
+            m_childrenBoundsDirty = false;
+            return m_childrenBounds;
+        }
+
+        utils::CRectangle CGraphicItem::boundingRectangle() const
+        {
+            // Swept shapes, so the bounds also hold for swept collision queries
+            const utils::CRectangle & children_bounds = childrenBounds();
+            if (children_bounds.width() < 0)
+            {
+                return sweptShape();
+            }
+
+            return sweptShape().united(children_bounds.translated(position()));
+        }
+
+        utils::CRectangle CGraphicItem::sweptShape() const
+        {
+            return sweptRectangle(shape(), position() - previousPosition());
+        }
+
+        void CGraphicItem::setBroadphaseIndex(CGraphicBroadphase * pIndex)
+        {
+            delete m_pBroadphaseIndex;
+            m_pBroadphaseIndex = pIndex;
+
+            if ((m_pBroadphaseIndex == nullptr) || (m_pChildren == nullptr))
+            {
+                return;
+            }
+
+            const size_t children_size = m_pChildren->size();
+            for (size_t i = 0; i < children_size; ++i)
+            {
+                m_pBroadphaseIndex->insert(m_pChildren->item(i));
+            }
         }
 
         bool CGraphicItem::addChild(CGraphicItem * pChild)
         {
             assert(pChild);
-            return utils::containers::gPushBackUnique(m_children, pChild);
+
+            if ((m_pChildren != nullptr) && (pChild->m_pStore == m_pChildren))
+            {
+                return false;
+            }
+
+            if (m_pChildren == nullptr)
+            {
+                m_pChildren = new CGraphicItemStore();
+            }
+
+            m_children.push_back(pChild);
+            pChild->m_pStore->transfer(pChild->m_slot, *m_pChildren);
+            assert(pChild->m_slot == m_children.size() - 1);
+
+            pChild->m_paintSequence = paint_sequence++;
+            insertPaintOrder(pChild);
+
+            invalidateBounds();
+            pChild->damage();
+
+            if (m_pBroadphaseIndex != nullptr)
+            {
+                m_pBroadphaseIndex->insert(pChild);
+            }
+
+            return true;
         }
 
         bool CGraphicItem::removeChild(CGraphicItem * pChild)
         {
             assert(pChild);
-            return utils::containers::gFindAndErase(m_children, pChild);
+
+            if ((m_pChildren == nullptr) || (pChild->m_pStore != m_pChildren))
+            {
+                return false;
+            }
+
+            if (m_pBroadphaseIndex != nullptr)
+            {
+                m_pBroadphaseIndex->remove(pChild);
+            }
+
+            pChild->damage();
+
+            // The slot of a child is also its index in m_children, both fill the hole with their
+            // last entry
+            const size_t slot = pChild->m_slot;
+            m_children[slot] = m_children.back();
+            m_children.pop_back();
+            m_pChildren->transfer(slot, detachedStore());
+            erasePaintOrder(pChild);
+
+            invalidateBounds();
+            childRemoved(pChild);
+
+            return true;
         }
 
         bool CGraphicItem::collidesWithItem(const IGraphicItem * pOther, collision_mode mode) const
         {
             assert(pOther);
 
-            utils::CRectangle item_rectangle = shape().translated(draw_offset(this));
-            utils::CRectangle other_rectangle = pOther->shape().translated(draw_offset(pOther));
-            return collides(item_rectangle, other_rectangle, mode);
+            return collides(sceneShape(),
+                            position() - previousPosition(),
+                            pOther->sceneShape(),
+                            pOther->position() - pOther->previousPosition(),
+                            mode) &&
+                   collidesExactly(this, pOther, mode);
         }
 
         bool CGraphicItem::collidesWithRectangle(const utils::CRectangle & otherRectangle,
@@ -110,10 +593,14 @@ namespace engine {
         {
             assert(otherRectangle.isValid());
 
-            utils::CRectangle item_rectangle = shape().translated(draw_offset(this));
-            utils::CRectangle other_rectangle_translated =
-                otherRectangle.translated(draw_offset(this));
-            return collides(item_rectangle, other_rectangle_translated, mode);
+            // The rectangle is expressed in the same space of the item, the one of its parent
+            const utils::CRectangle other_rectangle_translated =
+                otherRectangle.translated(scenePosition() - position());
+            return collides(sceneShape(),
+                            position() - previousPosition(),
+                            other_rectangle_translated,
+                            utils::CPoint(),
+                            mode);
         }
 
         CGraphicItem::TGraphicItems CGraphicItem::collidingItems(const IGraphicItem * pItem,
@@ -121,20 +608,79 @@ namespace engine {
         {
             TGraphicItems colliding_items;
 
-            const TGraphicItems & graphic_items = items();
-            auto it_end = graphic_items.end();
-            for (auto it = graphic_items.begin(); it != it_end; ++it)
+            const unsigned int mask = pItem->collisionMask();
+            if (mask == 0)
             {
-                IGraphicItem * p_other_item = (*it);
+                return colliding_items;
+            }
+
+            // The query shape is brought in the local space of the children, where the broadphase
+            // indexes their swept shapes and their bounds are cached
+            const utils::CPoint motion = pItem->position() - pItem->previousPosition();
+            const utils::CRectangle scene_query = pItem->sceneShape();
+            const utils::CRectangle query =
+                (mode == collision_mode::swept_intersect ? sweptRectangle(scene_query, motion)
+                                                         : scene_query)
+                    .translated(-scenePosition());
+            if (!touches(childrenBounds(), query))
+            {
+                return colliding_items;
+            }
+
+            if (m_pBroadphaseIndex != nullptr)
+            {
+                CGraphicBroadphase::TItems candidates;
+                m_pBroadphaseIndex->query(query, candidates);
 
+                auto it_end = candidates.end();
+                for (auto it = candidates.begin(); it != it_end; ++it)
+                {
+                    IGraphicItem * p_other_item = (*it);
+
+                    if ((p_other_item == pItem) ||
+                        ((mask & p_other_item->collisionCategory()) == 0))
+                    {
+                        continue;
+                    }
+
+                    if (pItem->collidesWithItem(p_other_item, mode))
+                    {
+                        colliding_items.push_back(p_other_item);
+                    }
+                }
+
+                return colliding_items;
+            }
+
+            // Stream the geometry of the children straight from the store, reaching the items only
+            // to refresh an outdated scene geometry
+            const CGraphicItemStore & store = *m_pChildren;
+            const size_t store_size = store.size();
+            for (size_t i = 0; i < store_size; ++i)
+            {
+                if ((mask & store.category(i)) == 0)
+                {
+                    continue;
+                }
+
+                CGraphicItem * p_other_item = store.item(i);
                 if (p_other_item == pItem)
                 {
                     continue;
                 }
 
-                if (pItem->collidesWithItem(p_other_item, mode))
+                if (store.isSceneDirty(i))
                 {
-                    utils::containers::gPushBackUnique(colliding_items, p_other_item);
+                    p_other_item->updateScene();
+                }
+
+                // Children are unique, so there is no need to check the output for duplicates
+                const utils::CPoint other_motion =
+                    store.position(i) - store.previousPosition(i, current_frame);
+                if (collides(scene_query, motion, store.sceneShape(i), other_motion, mode) &&
+                    collidesExactly(pItem, p_other_item, mode))
+                {
+                    colliding_items.push_back(p_other_item);
                 }
             }
 
@@ -143,19 +689,57 @@ namespace engine {
 
         CGraphicItem::TGraphicItems CGraphicItem::collidingItems(
             const utils::CRectangle & rectangle,
-            collision_mode mode) const
+            collision_mode mode,
+            unsigned int mask) const
         {
             TGraphicItems colliding_items;
 
-            const TGraphicItems & graphic_items = items();
-            auto it_end = graphic_items.end();
-            for (auto it = graphic_items.begin(); it != it_end; ++it)
+            if (!touches(childrenBounds(), rectangle))
+            {
+                return colliding_items;
+            }
+
+            if (m_pBroadphaseIndex != nullptr)
+            {
+                CGraphicBroadphase::TItems candidates;
+                m_pBroadphaseIndex->query(rectangle, candidates);
+
+                auto it_end = candidates.end();
+                for (auto it = candidates.begin(); it != it_end; ++it)
+                {
+                    IGraphicItem * p_item = (*it);
+
+                    if (((mask & p_item->collisionCategory()) != 0) &&
+                        p_item->collidesWithRectangle(rectangle, mode))
+                    {
+                        colliding_items.push_back(p_item);
+                    }
+                }
+
+                return colliding_items;
+            }
+
+            // The rectangle is expressed in the space of the children, the scene shapes are not
+            const utils::CRectangle query = rectangle.translated(scenePosition());
+            const CGraphicItemStore & store = *m_pChildren;
+            const size_t store_size = store.size();
+            for (size_t i = 0; i < store_size; ++i)
             {
-                IGraphicItem * p_item = (*it);
+                if ((mask & store.category(i)) == 0)
+                {
+                    continue;
+                }
+
+                if (store.isSceneDirty(i))
+                {
+                    store.item(i)->updateScene();
+                }
 
-                if (p_item->collidesWithRectangle(rectangle, mode))
+                const utils::CPoint item_motion =
+                    store.position(i) - store.previousPosition(i, current_frame);
+                if (collides(store.sceneShape(i), item_motion, query, utils::CPoint(), mode))
                 {
-                    utils::containers::gPushBackUnique(colliding_items, p_item);
+                    colliding_items.push_back(store.item(i));
                 }
             }
 
@@ -176,28 +760,126 @@ namespace engine {
                            !rectangle.contains(otherRectangle);
 
                 case collision_mode::intersect:
+                case collision_mode::swept_intersect:
                     return rectangle.intersects(otherRectangle);
             }
 
             return false;
         }
 
-        utils::CPoint CGraphicItem::draw_offset(const IGraphicItem * pItem)
+        bool CGraphicItem::collides(const utils::CRectangle & rectangle,
+                                    const utils::CPoint & motion,
+                                    const utils::CRectangle & otherRectangle,
+                                    const utils::CPoint & otherMotion,
+                                    collision_mode mode)
         {
-            utils::CPoint position;
+            if (mode != collision_mode::swept_intersect)
+            {
+                return collides(rectangle, otherRectangle, mode);
+            }
 
-            while (pItem != nullptr)
+            if (!rectangle.isValid())
             {
-                IGraphicItem * p_parent = pItem->parent();
-                if (p_parent != nullptr)
+                return false;
+            }
+
+            // The other rectangle is kept still at its previous position while the rectangle
+            // moves by the relative motion, from its previous position to the current one. The
+            // time of the motion runs from 0 to 1 and each axis gives the open interval of time
+            // the rectangles overlap along it (slab test)
+            const utils::CPoint relative_motion = motion - otherMotion;
+            const utils::CRectangle start = rectangle.translated(-motion);
+            const utils::CRectangle other_start = otherRectangle.translated(-otherMotion);
+
+            double enter = -std::numeric_limits<double>::infinity();
+            double exit = std::numeric_limits<double>::infinity();
+
+            auto slab = [&enter, &exit](double position,
+                                        double size,
+                                        double otherPosition,
+                                        double otherSize,
+                                        double delta) {
+                if (delta == 0.)
+                {
+                    if (position >= otherPosition + otherSize || otherPosition >= position + size)
+                    {
+                        exit = -std::numeric_limits<double>::infinity();
+                    }
+
+                    return;
+                }
+
+                double t0 = (otherPosition - (position + size)) / delta;
+                double t1 = (otherPosition + otherSize - position) / delta;
+                if (t0 > t1)
                 {
-                    position += p_parent->position();
+                    std::swap(t0, t1);
                 }
 
-                pItem = p_parent;
+                enter = std::max(enter, t0);
+                exit = std::min(exit, t1);
+            };
+
+            slab(start.x(), start.width(), other_start.x(), other_start.width(), relative_motion.x());
+            slab(start.y(),
+                 start.height(),
+                 other_start.y(),
+                 other_start.height(),
+                 relative_motion.y());
+
+            return enter < exit && enter < 1. && exit > 0.;
+        }
+
+        bool CGraphicItem::collidesExactly(const IGraphicItem * pItem,
+                                           const IGraphicItem * pOther,
+                                           collision_mode mode)
+        {
+            if (mode != collision_mode::intersect && mode != collision_mode::swept_intersect)
+            {
+                return true;
+            }
+
+            const utils::COpacityMask * p_mask = pItem->opacityMask();
+            const utils::COpacityMask * p_other_mask = pOther->opacityMask();
+            if ((p_mask == nullptr) || (p_other_mask == nullptr))
+            {
+                return true;
+            }
+
+            // Items which went through each other between two frames have nothing to refine
+            if (mode == collision_mode::swept_intersect &&
+                !pItem->sceneShape().intersects(pOther->sceneShape()))
+            {
+                return true;
+            }
+
+            // Same rounding used to draw the items
+            const utils::CPoint position = pItem->scenePosition();
+            const utils::CPoint other_position = pOther->scenePosition();
+            return p_mask->overlaps(*p_other_mask,
+                                    (int)other_position.x() - (int)position.x(),
+                                    (int)other_position.y() - (int)position.y());
+        }
+
+        utils::CRectangle CGraphicItem::sweptRectangle(const utils::CRectangle & rectangle,
+                                                       const utils::CPoint & motion)
+        {
+            return rectangle.united(rectangle.translated(-motion));
+        }
+
+        bool CGraphicItem::touches(const utils::CRectangle & rectangle,
+                                   const utils::CRectangle & otherRectangle)
+        {
+            if (rectangle.width() < 0 || rectangle.height() < 0 || otherRectangle.width() < 0 ||
+                otherRectangle.height() < 0)
+            {
+                return false;
             }
 
-            return position;
+            return rectangle.x() <= otherRectangle.x() + otherRectangle.width() &&
+                   otherRectangle.x() <= rectangle.x() + rectangle.width() &&
+                   rectangle.y() <= otherRectangle.y() + otherRectangle.height() &&
+                   otherRectangle.y() <= rectangle.y() + rectangle.height();
         }
 
     } // namespace graphic
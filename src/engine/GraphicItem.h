@@ -21,23 +21,48 @@
 #include <IGraphicItem.h>
 #include <IPlatformManager.h>
 #include <Rectangle.h>
+#include <cstdint>
+
+namespace utils {
+    class CDrawList;
+}
 
 namespace engine {
     namespace graphic {
 
+        class CGraphicBroadphase;
+        class CGraphicItemStore;
+
         /**
          * @brief CGraphicItem organize themselves in object trees. When a CGraphicItem is created
          * with another object as parent, the object will automatically add itself to the parent's
          * items() list. The parent takes ownership of the object; i.e., it will automatically
-         * delete its children in its destructor
+         * delete its children in its destructor.
+         * The geometry of the item is not stored in the item itself but in a slot of the
+         * CGraphicItemStore of its parent, next to the one of its siblings
          */
         class CGraphicItem : public virtual utils::interfaces::IGraphicItem
         {
+          public:
+            typedef std::vector<CGraphicItem *> TPaintOrder;
+
+            /**
+             * @brief Concrete type of an item, so the engine can downcast its items with a
+             * static_cast instead of a dynamic_cast
+             */
+            enum class item_type : std::uint8_t
+            {
+                item,
+                bitmap,
+                textfield,
+                container
+            };
+
           public:
             /**
-             * @brief Constructs a CGraphicItem with the given pParent item
+             * @brief Constructs a CGraphicItem of the given type with the given pParent item
              */
-            CGraphicItem(CGraphicItem * pParent = nullptr);
+            CGraphicItem(CGraphicItem * pParent = nullptr, item_type type = item_type::item);
 
             /**
              * @brief Destroys the CGraphicItem and all its children
@@ -47,25 +72,100 @@ namespace engine {
             CGraphicItem(const CGraphicItem &) = delete;
             CGraphicItem & operator=(const CGraphicItem &) = delete;
 
-            virtual void paint() { draw(draw_offset(this) + position()); }
+            virtual void paint() { draw(scenePosition()); }
+
+            /**
+             * @brief Starts a new frame. The positions the items have at this point become their
+             * previous positions, from which the swept collisions are tested
+             */
+            static void advanceFrame();
+
+            /**
+             * @brief Enables the recording of the regions of the scene changed by the items: moves,
+             * resizes, additions, removals and any change of what an item paints. Off by default
+             */
+            static void setDamageTracking(bool enabled);
+
+            /**
+             * @brief Adds the regions of the scene changed since the last call to the draw list,
+             * and forgets them
+             */
+            static void flushDamage(utils::CDrawList & drawList);
+
+            item_type itemType() const { return m_type; }
 
             utils::interfaces::IGraphicItem * parent() const;
-            void setParent(utils::interfaces::IGraphicItem * pParent);
+            void setParent(CGraphicItem * pParent);
 
-            utils::CPoint position() const { return m_rectangle.position(); }
-            void setPosition(const utils::CPoint & position) { m_rectangle.setPosition(position); }
-            void setPosition(double x, double y) { m_rectangle.setPosition(x, y); }
+            utils::CPoint position() const;
+            utils::CPoint previousPosition() const;
+            void setPosition(const utils::CPoint & position);
+            void setPosition(double x, double y);
 
-            utils::CSize size() const { return m_rectangle.size(); }
-            void setSize(const utils::CSize & size) { m_rectangle.setSize(size); }
-            void setSize(double w, double h) { m_rectangle.setSize(utils::CSize(w, h)); }
+            utils::CSize size() const;
+            void setSize(const utils::CSize & size);
+            void setSize(double w, double h);
 
-            utils::CRectangle rectangle() const { return m_rectangle; }
+            utils::CRectangle rectangle() const;
             void setRectangle(const utils::CRectangle & rectangle);
             void setRectangle(double x, double y, double width, double height);
 
             const TGraphicItems & items() const { return m_children; }
-            virtual utils::CRectangle shape() const { return m_rectangle; }
+
+            /**
+             * @brief Retrieves the children as engine items, in the order of items()
+             */
+            size_t childCount() const { return m_children.size(); }
+            CGraphicItem * child(size_t index) const;
+            virtual utils::CRectangle shape() const { return rectangle(); }
+
+            int layer() const { return m_layer; }
+            void setLayer(int layer);
+            double zValue() const { return m_zValue; }
+            void setZValue(double z);
+
+            /**
+             * @brief Returns the children in the order they are painted. The list is kept sorted
+             * as the children are added, removed and moved to another layer or z value. The entries
+             * of the removed children are nullptr until the list is compacted, the last entry is
+             * never nullptr
+             */
+            const TPaintOrder & paintOrder() const { return m_paintOrder; }
+
+            /**
+             * @brief Returns the rectangle the item covers when painted, in the space of the
+             * parent. Empty for the items which do not paint anything themselves
+             */
+            virtual utils::CRectangle paintRectangle() const { return rectangle(); }
+
+            utils::CPoint scenePosition() const;
+            utils::CRectangle sceneShape() const;
+
+            /**
+             * @brief Returns the shape of the item united to the one it had at the beginning of the
+             * frame, in the space of the parent
+             */
+            utils::CRectangle sweptShape() const;
+
+            /**
+             * @brief Returns the union of the bounding rectangles of the children, in the space of
+             * the children. The union is cached and refreshed only after a descendant has changed.
+             * A negative size means the item has no children
+             */
+            const utils::CRectangle & childrenBounds() const;
+
+            /**
+             * @brief Returns the shape of the item united to the bounds of all its descendants, in
+             * the space of the parent
+             */
+            utils::CRectangle boundingRectangle() const;
+
+            unsigned int collisionCategory() const;
+            void setCollisionCategory(unsigned int category);
+            unsigned int collisionMask() const;
+            void setCollisionMask(unsigned int mask);
+
+            virtual const utils::COpacityMask * opacityMask() const { return nullptr; }
 
             bool collidesWithItem(const IGraphicItem * pOther,
                                   collision_mode mode = collision_mode::intersect) const;
@@ -77,7 +177,8 @@ namespace engine {
                                          collision_mode mode = collision_mode::intersect) const;
 
             TGraphicItems collidingItems(const utils::CRectangle & rectangle,
-                                         collision_mode mode = collision_mode::intersect) const;
+                                         collision_mode mode = collision_mode::intersect,
+                                         unsigned int mask = collision_mask_all) const;
 
           protected:
             void draw(const utils::CPoint & position)
@@ -91,7 +192,85 @@ namespace engine {
                                  const utils::CRectangle & otherRectangle,
                                  collision_mode mode = collision_mode::intersect);
 
+            /**
+             * @brief As above, where each rectangle arrived at its position moving by the given
+             * motion since the beginning of the frame. Only swept_intersect makes use of motions
+             */
+            static bool collides(const utils::CRectangle & rectangle,
+                                 const utils::CPoint & motion,
+                                 const utils::CRectangle & otherRectangle,
+                                 const utils::CPoint & otherMotion,
+                                 collision_mode mode);
+
+            /**
+             * @brief Refines a collision between the shapes of two items with their opacity
+             * masks. Returns true when the mode or the items do not allow the exact test. In
+             * swept mode, only items whose shapes overlap at their current positions are refined
+             */
+            static bool collidesExactly(const IGraphicItem * pItem,
+                                        const IGraphicItem * pOther,
+                                        collision_mode mode);
+
+            /**
+             * @brief Returns the rectangle united to the one it was before moving by motion
+             */
+            static utils::CRectangle sweptRectangle(const utils::CRectangle & rectangle,
+                                                    const utils::CPoint & motion);
+
+            /**
+             * @brief Returns true if the rectangles overlap or share an edge. Used to discard
+             * whole subtrees before the exact tests, so it errs on the inclusive side. A rectangle
+             * with a negative size touches nothing
+             */
+            static bool touches(const utils::CRectangle & rectangle,
+                                const utils::CRectangle & otherRectangle);
+
+            /**
+             * @brief Indexes the children in the given broadphase, which the item takes ownership
+             * of, so collision queries only test the children close to the query. nullptr removes
+             * the index and restores the brute force scan of all the children
+             */
+            void setBroadphaseIndex(CGraphicBroadphase * pIndex);
+            const CGraphicBroadphase * broadphaseIndex() const { return m_pBroadphaseIndex; }
+
+            /**
+             * @brief Must be called every time the shape of the item changes, so the parent can
+             * keep its spatial index up to date and the cached scene geometry is refreshed
+             */
+            void shapeChanged();
+
+            /**
+             * @brief Records the region of the scene covered by the item and its descendants as
+             * damaged, when the damage tracking is enabled. Must be called before and after every
+             * change of what the item paints, so both the old and the new content are redrawn
+             */
+            void damage() const;
+
+            /**
+             * @brief Called after a child has been removed from the item, either because it has
+             * been moved to another parent or because it is being destroyed
+             */
+            virtual void childRemoved(CGraphicItem * /*pChild*/) {}
+
           private:
+            friend class CGraphicItemStore;
+
+            /**
+             * @brief Store of the items without a parent
+             */
+            static CGraphicItemStore & detachedStore();
+
+            /**
+             * @brief Regions of the scene damaged since the last flushDamage
+             */
+            static std::vector<utils::CRectangle> & damagedRegions();
+
+            /**
+             * @brief Returns the paint rectangle of the item united to the ones of all its
+             * descendants, in the space of the parent
+             */
+            utils::CRectangle paintBounds() const;
+
             /**
              * @brief Internal call between CGraphicItem(s) to add a child on another item
              */
@@ -103,16 +282,63 @@ namespace engine {
             bool removeChild(CGraphicItem * pChild);
 
             /**
-             * @brief Calculates the offset between the relative coordinates of the item and the
-             * main window 0,0 coordinates
+             * @brief Returns true if pItem is painted before pOther, both children of the same item
+             */
+            static bool paintsBefore(const CGraphicItem * pItem, const CGraphicItem * pOther);
+
+            /**
+             * @brief Add and remove a child in the paint order. A child sorting after all the
+             * others is appended and a removed one leaves a hole, both in constant time on
+             * average. Inserting before other children compacts the list and shifts it
+             */
+            void insertPaintOrder(CGraphicItem * pChild);
+            void erasePaintOrder(CGraphicItem * pChild);
+
+            /**
+             * @brief Drops the holes left in the paint order by the removed children
+             */
+            void compactPaintOrder();
+
+            /**
+             * @brief Marks the cached scene geometry of the item and all its descendants as
+             * outdated. A dirty item always has dirty descendants, so the walk stops as soon as it
+             * meets an item already dirty
+             */
+            void invalidateScene();
+
+            /**
+             * @brief Recalculates the cached scene geometry from the one of the parent
+             */
+            void updateScene() const;
+
+            /**
+             * @brief Marks the cached children bounds of the item and of all its ancestors as
+             * outdated. A dirty item always has dirty ancestors, so the walk stops as soon as it
+             * meets an item already dirty
              */
-            static utils::CPoint draw_offset(const IGraphicItem * pItem);
+            void invalidateBounds();
 
           private:
-            utils::CRectangle m_rectangle;
+            const item_type m_type;
+
+            CGraphicItemStore * m_pStore{nullptr}; /* Store holding the geometry of the item */
+            size_t m_slot{0};                      /* Slot of the item in m_pStore */
 
-            IGraphicItem * m_pParent{nullptr};
+            CGraphicItem * m_pParent{nullptr};
             TGraphicItems m_children;
+            CGraphicItemStore * m_pChildren{nullptr}; /* Geometry of m_children, same order */
+            TPaintOrder m_paintOrder;                 /* m_children sorted by paintsBefore */
+            size_t m_paintOrderHoles{0};              /* nullptr entries of m_paintOrder */
+            size_t m_paintIndex{0};                   /* Index in the paint order of the parent */
+
+            int m_layer{0};
+            double m_zValue{0.0};
+            unsigned long long m_paintSequence{0}; /* Order of the addition to the parent */
+
+            mutable utils::CRectangle m_childrenBounds;
+            mutable bool m_childrenBoundsDirty{true};
+
+            CGraphicBroadphase * m_pBroadphaseIndex{nullptr};
         };
 
     } // namespace graphic
@@ -0,0 +1,170 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#include "GraphicItem.h"
+#include "GraphicItemStore.h"
+#include <cassert>
+
+namespace engine {
+    namespace graphic {
+
+        void CGraphicItemStore::insert(CGraphicItem * pItem, unsigned int frame)
+        {
+            assert(pItem);
+
+            pushBack(pItem);
+
+            m_x.push_back(0);
+            m_y.push_back(0);
+            m_width.push_back(0);
+            m_height.push_back(0);
+
+            m_previousX.push_back(0);
+            m_previousY.push_back(0);
+            m_moveFrame.push_back(frame);
+            m_spawnFrame.push_back(frame);
+
+            m_sceneX.push_back(0);
+            m_sceneY.push_back(0);
+            m_sceneShapeX.push_back(0);
+            m_sceneShapeY.push_back(0);
+            m_sceneShapeWidth.push_back(0);
+            m_sceneShapeHeight.push_back(0);
+            m_sceneDirty.push_back(1);
+
+            // Copied first, push_back would bind a reference to the undefined class constants
+            const unsigned int category =
+                utils::interfaces::IGraphicItem::collision_category_default;
+            const unsigned int mask = utils::interfaces::IGraphicItem::collision_mask_all;
+            m_category.push_back(category);
+            m_mask.push_back(mask);
+        }
+
+        void CGraphicItemStore::erase(size_t slot)
+        {
+            assert(slot < m_items.size());
+
+            // The last entry fills the hole, so nothing else moves
+            const size_t last = m_items.size() - 1;
+            if (slot != last)
+            {
+                m_items[slot] = m_items[last];
+                m_items[slot]->m_slot = slot;
+
+                m_x[slot] = m_x[last];
+                m_y[slot] = m_y[last];
+                m_width[slot] = m_width[last];
+                m_height[slot] = m_height[last];
+
+                m_previousX[slot] = m_previousX[last];
+                m_previousY[slot] = m_previousY[last];
+                m_moveFrame[slot] = m_moveFrame[last];
+                m_spawnFrame[slot] = m_spawnFrame[last];
+
+                m_sceneX[slot] = m_sceneX[last];
+                m_sceneY[slot] = m_sceneY[last];
+                m_sceneShapeX[slot] = m_sceneShapeX[last];
+                m_sceneShapeY[slot] = m_sceneShapeY[last];
+                m_sceneShapeWidth[slot] = m_sceneShapeWidth[last];
+                m_sceneShapeHeight[slot] = m_sceneShapeHeight[last];
+                m_sceneDirty[slot] = m_sceneDirty[last];
+
+                m_category[slot] = m_category[last];
+                m_mask[slot] = m_mask[last];
+            }
+
+            m_items.pop_back();
+
+            m_x.pop_back();
+            m_y.pop_back();
+            m_width.pop_back();
+            m_height.pop_back();
+
+            m_previousX.pop_back();
+            m_previousY.pop_back();
+            m_moveFrame.pop_back();
+            m_spawnFrame.pop_back();
+
+            m_sceneX.pop_back();
+            m_sceneY.pop_back();
+            m_sceneShapeX.pop_back();
+            m_sceneShapeY.pop_back();
+            m_sceneShapeWidth.pop_back();
+            m_sceneShapeHeight.pop_back();
+            m_sceneDirty.pop_back();
+
+            m_category.pop_back();
+            m_mask.pop_back();
+        }
+
+        void CGraphicItemStore::transfer(size_t slot, CGraphicItemStore & target)
+        {
+            assert(slot < m_items.size());
+            assert(&target != this);
+
+            // The cached scene geometry travels with the item: the caller invalidates it, and the
+            // dirty flag must stay consistent with the one of the descendants
+            target.pushBack(m_items[slot]);
+
+            target.m_x.push_back(m_x[slot]);
+            target.m_y.push_back(m_y[slot]);
+            target.m_width.push_back(m_width[slot]);
+            target.m_height.push_back(m_height[slot]);
+
+            target.m_previousX.push_back(m_previousX[slot]);
+            target.m_previousY.push_back(m_previousY[slot]);
+            target.m_moveFrame.push_back(m_moveFrame[slot]);
+            target.m_spawnFrame.push_back(m_spawnFrame[slot]);
+
+            target.m_sceneX.push_back(m_sceneX[slot]);
+            target.m_sceneY.push_back(m_sceneY[slot]);
+            target.m_sceneShapeX.push_back(m_sceneShapeX[slot]);
+            target.m_sceneShapeY.push_back(m_sceneShapeY[slot]);
+            target.m_sceneShapeWidth.push_back(m_sceneShapeWidth[slot]);
+            target.m_sceneShapeHeight.push_back(m_sceneShapeHeight[slot]);
+            target.m_sceneDirty.push_back(m_sceneDirty[slot]);
+
+            target.m_category.push_back(m_category[slot]);
+            target.m_mask.push_back(m_mask[slot]);
+
+            erase(slot);
+        }
+
+        void CGraphicItemStore::pushBack(CGraphicItem * pItem)
+        {
+            m_items.push_back(pItem);
+            pItem->m_pStore = this;
+            pItem->m_slot = m_items.size() - 1;
+        }
+
+        void CGraphicItemStore::setScene(size_t slot,
+                                         const utils::CPoint & position,
+                                         const utils::CRectangle & shape)
+        {
+            m_sceneX[slot] = position.x();
+            m_sceneY[slot] = position.y();
+            m_sceneShapeX[slot] = shape.x();
+            m_sceneShapeY[slot] = shape.y();
+            m_sceneShapeWidth[slot] = shape.width();
+            m_sceneShapeHeight[slot] = shape.height();
+            m_sceneDirty[slot] = 0;
+        }
+
+    } // namespace graphic
+} // namespace engine
@@ -0,0 +1,182 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#pragma once
+#include <Rectangle.h>
+#include <vector>
+
+namespace engine {
+    namespace graphic {
+
+        class CGraphicItem;
+
+        /**
+         * @brief CGraphicItemStore keeps the geometry of a set of sibling items in contiguous
+         * arrays (structure of arrays). The items only remember their slot in the store, so bulk
+         * passes like painting, moving and collision checks stream linearly through memory instead
+         * of chasing the items across the heap. Slots follow the order of the parent's items()
+         */
+        class CGraphicItemStore final
+        {
+          public:
+            CGraphicItemStore() = default;
+            CGraphicItemStore(const CGraphicItemStore &) = delete;
+            CGraphicItemStore & operator=(const CGraphicItemStore &) = delete;
+
+            inline size_t size() const noexcept { return m_items.size(); }
+            inline bool empty() const noexcept { return m_items.empty(); }
+            inline CGraphicItem * item(size_t slot) const { return m_items[slot]; }
+
+            /**
+             * @brief Appends an item with an empty geometry and binds the item to its new slot.
+             * The item does not sweep until the frame after the given one
+             */
+            void insert(CGraphicItem * pItem, unsigned int frame);
+
+            /**
+             * @brief Removes the given slot in constant time: the entry of the last slot is moved
+             * into it and its item is notified of the new slot
+             */
+            void erase(size_t slot);
+
+            /**
+             * @brief Moves the entry at the given slot, with all its values, at the end of the
+             * target store and binds the item to its new slot
+             */
+            void transfer(size_t slot, CGraphicItemStore & target);
+
+            inline double x(size_t slot) const { return m_x[slot]; }
+            inline double y(size_t slot) const { return m_y[slot]; }
+            inline double width(size_t slot) const { return m_width[slot]; }
+            inline double height(size_t slot) const { return m_height[slot]; }
+
+            inline utils::CPoint position(size_t slot) const
+            {
+                return utils::CPoint(m_x[slot], m_y[slot]);
+            }
+
+            inline utils::CSize size(size_t slot) const
+            {
+                return utils::CSize(m_width[slot], m_height[slot]);
+            }
+
+            inline utils::CRectangle rectangle(size_t slot) const
+            {
+                return utils::CRectangle(m_x[slot], m_y[slot], m_width[slot], m_height[slot]);
+            }
+
+            inline void setPosition(size_t slot, double x, double y)
+            {
+                m_x[slot] = x;
+                m_y[slot] = y;
+            }
+
+            inline void setSize(size_t slot, double width, double height)
+            {
+                m_width[slot] = width;
+                m_height[slot] = height;
+            }
+
+            /**
+             * @brief Must be called before moving the item: the first move of a frame records the
+             * position the item had at the beginning of the frame
+             */
+            inline void beginMove(size_t slot, unsigned int frame)
+            {
+                if (m_moveFrame[slot] == frame)
+                {
+                    return;
+                }
+
+                m_previousX[slot] = m_x[slot];
+                m_previousY[slot] = m_y[slot];
+                m_moveFrame[slot] = frame;
+            }
+
+            /**
+             * @brief Retrieves the position the item had at the beginning of the given frame
+             */
+            inline utils::CPoint previousPosition(size_t slot, unsigned int frame) const
+            {
+                if (m_moveFrame[slot] != frame || m_spawnFrame[slot] == frame)
+                {
+                    return position(slot);
+                }
+
+                return utils::CPoint(m_previousX[slot], m_previousY[slot]);
+            }
+
+            inline bool isSceneDirty(size_t slot) const { return m_sceneDirty[slot] != 0; }
+            inline void setSceneDirty(size_t slot) { m_sceneDirty[slot] = 1; }
+
+            inline utils::CPoint scenePosition(size_t slot) const
+            {
+                return utils::CPoint(m_sceneX[slot], m_sceneY[slot]);
+            }
+
+            inline utils::CRectangle sceneShape(size_t slot) const
+            {
+                return utils::CRectangle(m_sceneShapeX[slot],
+                                         m_sceneShapeY[slot],
+                                         m_sceneShapeWidth[slot],
+                                         m_sceneShapeHeight[slot]);
+            }
+
+            void setScene(size_t slot,
+                          const utils::CPoint & position,
+                          const utils::CRectangle & shape);
+
+            inline unsigned int category(size_t slot) const { return m_category[slot]; }
+            inline unsigned int mask(size_t slot) const { return m_mask[slot]; }
+            inline void setCategory(size_t slot, unsigned int category)
+            {
+                m_category[slot] = category;
+            }
+            inline void setMask(size_t slot, unsigned int mask) { m_mask[slot] = mask; }
+
+          private:
+            void pushBack(CGraphicItem * pItem);
+
+          private:
+            std::vector<CGraphicItem *> m_items;
+
+            std::vector<double> m_x;
+            std::vector<double> m_y;
+            std::vector<double> m_width;
+            std::vector<double> m_height;
+
+            std::vector<double> m_previousX; /* Position at the beginning of m_moveFrame */
+            std::vector<double> m_previousY;
+            std::vector<unsigned int> m_moveFrame;
+            std::vector<unsigned int> m_spawnFrame; /* Moves in the frame of insertion teleport */
+
+            std::vector<double> m_sceneX; /* Cached position in window coordinates */
+            std::vector<double> m_sceneY;
+            std::vector<double> m_sceneShapeX; /* Cached shape in window coordinates */
+            std::vector<double> m_sceneShapeY;
+            std::vector<double> m_sceneShapeWidth;
+            std::vector<double> m_sceneShapeHeight;
+            std::vector<unsigned char> m_sceneDirty;
+
+            std::vector<unsigned int> m_category;
+            std::vector<unsigned int> m_mask;
+        };
+
+    } // namespace graphic
+} // namespace engine
@@ -0,0 +1,172 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#include "GraphicItem.h"
+#include "GraphicSweepAndPrune.h"
+#include <algorithm>
+#include <cassert>
+
+namespace engine {
+    namespace graphic {
+
+        void CGraphicSweepAndPrune::insert(CGraphicItem * pItem)
+        {
+            assert(pItem);
+
+            SEntry & entry = m_entries[pItem];
+            if (entry.pItem != nullptr)
+            {
+                return;
+            }
+
+            entry.pItem = pItem;
+            entry.index = m_sorted.size();
+            bounds(entry);
+
+            m_sorted.push_back(&entry);
+            m_unsorted = true;
+        }
+
+        void CGraphicSweepAndPrune::remove(CGraphicItem * pItem)
+        {
+            assert(pItem);
+
+            auto it = m_entries.find(pItem);
+            if (it == m_entries.end())
+            {
+                return;
+            }
+
+            // The hole keeps the relative order of the other entries until the next sort
+            m_sorted[it->second.index] = nullptr;
+            m_entries.erase(it);
+            m_unsorted = true;
+        }
+
+        void CGraphicSweepAndPrune::update(CGraphicItem * pItem)
+        {
+            assert(pItem);
+
+            auto it = m_entries.find(pItem);
+            if (it == m_entries.end())
+            {
+                return;
+            }
+
+            bounds(it->second);
+            m_unsorted = true;
+        }
+
+        void CGraphicSweepAndPrune::query(const utils::CRectangle & rectangle,
+                                          TItems & candidates) const
+        {
+            sort();
+
+            const double left = rectangle.x();
+            const double top = rectangle.y();
+            const double right = std::max(left, left + rectangle.width());
+            const double bottom = std::max(top, top + rectangle.height());
+
+            // No entry starting before left - m_maxWidth can reach the query
+            auto it = std::lower_bound(m_sorted.begin(),
+                                       m_sorted.end(),
+                                       left - m_maxWidth,
+                                       [](const SEntry * pEntry, double value) {
+                                           return pEntry->left < value;
+                                       });
+
+            auto it_end = m_sorted.end();
+            for (; it != it_end && (*it)->left <= right; ++it)
+            {
+                const SEntry * p_entry = (*it);
+                if (p_entry->right >= left && p_entry->top <= bottom && p_entry->bottom >= top)
+                {
+                    candidates.push_back(p_entry->pItem);
+                }
+            }
+        }
+
+        void CGraphicSweepAndPrune::pairs(TItemsPairs & candidates) const
+        {
+            sort();
+
+            const size_t sorted_size = m_sorted.size();
+            for (size_t i = 0; i < sorted_size; ++i)
+            {
+                const SEntry * p_entry = m_sorted[i];
+                for (size_t k = i + 1; k < sorted_size && m_sorted[k]->left <= p_entry->right; ++k)
+                {
+                    const SEntry * p_other = m_sorted[k];
+                    if (p_other->top <= p_entry->bottom && p_other->bottom >= p_entry->top)
+                    {
+                        candidates.push_back(std::make_pair(p_entry->pItem, p_other->pItem));
+                    }
+                }
+            }
+        }
+
+        void CGraphicSweepAndPrune::bounds(SEntry & entry)
+        {
+            const utils::CRectangle shape = entry.pItem->sweptShape();
+            entry.left = shape.x();
+            entry.top = shape.y();
+            entry.right = std::max(entry.left, entry.left + shape.width());
+            entry.bottom = std::max(entry.top, entry.top + shape.height());
+        }
+
+        void CGraphicSweepAndPrune::sort() const
+        {
+            if (!m_unsorted)
+            {
+                return;
+            }
+
+            m_maxWidth = 0;
+
+            // The entries sorted so far are packed at the front, over the holes
+            size_t count = 0;
+            const size_t sorted_size = m_sorted.size();
+            for (size_t i = 0; i < sorted_size; ++i)
+            {
+                SEntry * p_entry = m_sorted[i];
+                if (p_entry == nullptr)
+                {
+                    continue;
+                }
+
+                m_maxWidth = std::max(m_maxWidth, p_entry->right - p_entry->left);
+
+                size_t k = count;
+                for (; k > 0 && m_sorted[k - 1]->left > p_entry->left; --k)
+                {
+                    m_sorted[k] = m_sorted[k - 1];
+                    m_sorted[k]->index = k;
+                }
+
+                m_sorted[k] = p_entry;
+                p_entry->index = k;
+                ++count;
+            }
+
+            m_sorted.resize(count);
+            m_unsorted = false;
+        }
+
+    } // namespace graphic
+} // namespace engine
@@ -0,0 +1,84 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#pragma once
+#include "GraphicBroadphase.h"
+#include <unordered_map>
+#include <vector>
+
+namespace engine {
+    namespace graphic {
+
+        /**
+         * @brief CGraphicSweepAndPrune keeps the children of a CGraphicItem sorted along the x
+         * axis. Moving items only marks the list as unsorted; the next query restores the order
+         * with an insertion sort, which is close to linear when items keep their relative order
+         * from one frame to the next (e.g. rows of aliens moving together). Removing items leaves
+         * holes in the list, closed by the same sort
+         */
+        class CGraphicSweepAndPrune final : public CGraphicBroadphase
+        {
+          public:
+            CGraphicSweepAndPrune() = default;
+
+            // CGraphicBroadphase
+            void insert(CGraphicItem * pItem) override;
+            void remove(CGraphicItem * pItem) override;
+            void update(CGraphicItem * pItem) override;
+            void query(const utils::CRectangle & rectangle, TItems & candidates) const override;
+            //~CGraphicBroadphase
+
+            /**
+             * @brief Appends to candidates every pair of items whose bounds overlap, in a single
+             * sweep of the sorted list. Each pair is reported once; the caller is in charge of
+             * the exact shape test
+             */
+            void pairs(TItemsPairs & candidates) const;
+
+          private:
+            struct SEntry
+            {
+                CGraphicItem * pItem{nullptr};
+                double left{0};
+                double top{0};
+                double right{0};
+                double bottom{0};
+                size_t index{0}; /* Position in m_sorted */
+            };
+
+            typedef std::vector<SEntry *> TSortedEntries;
+            typedef std::unordered_map<const CGraphicItem *, SEntry> TEntries;
+
+            static void bounds(SEntry & entry);
+
+            /**
+             * @brief Restores the order of the list and the widest extent along x, and drops the
+             * holes of the removed entries
+             */
+            void sort() const;
+
+          private:
+            TEntries m_entries;
+            mutable TSortedEntries m_sorted; /* Sorted, without holes, once m_unsorted is false */
+            mutable bool m_unsorted{false};
+            mutable double m_maxWidth{0}; /* Bounds how far before a query an entry may start */
+        };
+
+    } // namespace graphic
+} // namespace engine
@@ -19,8 +19,10 @@
 
 #include "Framework.h"
 #include "GraphicTextfield.h"
+#include <BitmapFont.h>
 #include <cassert>
 #include <cstdarg>
+#include <cstring>
 
 #include "ISystemGlobalEnvironment.h"
 extern utils::interfaces::SSystemGlobalEnvironment * g_env;
@@ -28,18 +30,83 @@ extern utils::interfaces::SSystemGlobalEnvironment * g_env;
 namespace engine {
     namespace graphic {
 
-        CGraphicTextfield::CGraphicTextfield(CGraphicItem * pParent) : CGraphicItem(pParent)
+        static const char digit_pairs[] = "00010203040506070809"
+                                          "10111213141516171819"
+                                          "20212223242526272829"
+                                          "30313233343536373839"
+                                          "40414243444546474849"
+                                          "50515253545556575859"
+                                          "60616263646566676869"
+                                          "70717273747576777879"
+                                          "80818283848586878889"
+                                          "90919293949596979899";
+
+        /**
+         * @brief Writes value in decimal right before pEnd, two digits at a time, and returns the
+         * first character written
+         */
+        static char * formatInteger(char * pEnd, int value)
+        {
+            // Unsigned, so the lowest int can be negated
+            unsigned int magnitude = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+
+            char * p_char = pEnd;
+            while (magnitude >= 100)
+            {
+                const unsigned int pair = (magnitude % 100) * 2;
+                magnitude /= 100;
+                *--p_char = digit_pairs[pair + 1];
+                *--p_char = digit_pairs[pair];
+            }
+
+            if (magnitude >= 10)
+            {
+                *--p_char = digit_pairs[magnitude * 2 + 1];
+                *--p_char = digit_pairs[magnitude * 2];
+            }
+            else
+            {
+                *--p_char = (char)('0' + magnitude);
+            }
+
+            if (value < 0)
+            {
+                *--p_char = '-';
+            }
+
+            return p_char;
+        }
+
+        CGraphicTextfield::CGraphicTextfield(CGraphicItem * pParent)
+            : CGraphicItem(pParent, item_type::textfield)
         {
             setPosition(0, 0);
         }
 
         CGraphicTextfield::CGraphicTextfield(const char * text, CGraphicItem * pParent)
-            : CGraphicItem(pParent)
+            : CGraphicItem(pParent, item_type::textfield)
         {
             setText(text);
             setPosition(0, 0);
         }
 
+        void * CGraphicTextfield::operator new(size_t size)
+        {
+            auto * p_framework = static_cast<CFramework *>(g_env->pFramework);
+            assert(p_framework);
+            assert(size <= p_framework->itemPool(item_type::textfield).blockSize());
+
+            return p_framework->itemPool(item_type::textfield).allocate();
+        }
+
+        void CGraphicTextfield::operator delete(void * pTextfield)
+        {
+            auto * p_framework = static_cast<CFramework *>(g_env->pFramework);
+            assert(p_framework);
+
+            p_framework->itemPool(item_type::textfield).release(pTextfield);
+        }
+
         void CGraphicTextfield::setText(const char * format, ...)
         {
             assert(format && format[0]);
@@ -48,24 +115,81 @@ namespace engine {
             va_start(arg_list, format);
 
             char temp[4096];
-            vsnprintf_s(temp, 4096, format, arg_list);
+            vsnprintf(temp, sizeof(temp), format, arg_list);
             temp[4095] = '\0';
 
             va_end(arg_list);
-            m_text = temp;
+
+            assignText(temp, strlen(temp));
+        }
+
+        void CGraphicTextfield::setNumber(const char * prefix, int value)
+        {
+            assert(prefix);
+
+            char digits[16];
+            char * const p_end = digits + sizeof(digits);
+            const char * p_digits = formatInteger(p_end, value);
+
+            assignText(prefix, strlen(prefix), p_digits, p_end - p_digits);
+        }
+
+        void CGraphicTextfield::assignText(const char * text,
+                                           size_t length,
+                                           const char * suffix,
+                                           size_t suffixLength)
+        {
+            if ((m_text.size() == length + suffixLength) &&
+                (m_text.compare(0, length, text, length) == 0) &&
+                (m_text.compare(length, suffixLength, suffix, suffixLength) == 0))
+            {
+                return;
+            }
+
+            // Within its capacity, the string is rewritten without allocating
+            damage();
+            m_text.assign(text, length);
+            m_text.append(suffix, suffixLength);
+            m_glyphsDirty = true;
+            damage();
+        }
+
+        utils::CRectangle CGraphicTextfield::paintRectangle() const
+        {
+            // The texts are measured with the font of the platforms supporting partial updates
+            return utils::CRectangle(position(), utils::CBitmapFont::textSize(m_text.c_str()));
         }
 
         void CGraphicTextfield::draw(int x, int y)
         {
+            if (m_text.empty())
+            {
+                return;
+            }
+
             auto * p_framework = static_cast<CFramework *>(g_env->pFramework);
             assert(p_framework);
 
-            utils::interfaces::IPlatform * p_platform = p_framework->platform();
-            assert(p_platform);
+            const CGlyphAtlas * p_glyphs = p_framework->glyphAtlas();
+            if (p_glyphs == nullptr)
+            {
+                p_framework->drawList().addText(x, y, m_text.c_str());
+                return;
+            }
+
+            if (m_glyphsDirty)
+            {
+                CGlyphAtlas::layout(m_text.c_str(), m_glyphs);
+                m_glyphsDirty = false;
+            }
 
-            if (!m_text.empty())
+            utils::CDrawList & draw_list = p_framework->drawList();
+            for (const CGlyphAtlas::SQuad & glyph : m_glyphs)
             {
-                p_platform->drawText(x, y, m_text.c_str());
+                draw_list.addGlyph(x + glyph.x,
+                                   y + glyph.y,
+                                   glyph.character,
+                                   p_glyphs->glyphRectangle(glyph.character));
             }
         }
 
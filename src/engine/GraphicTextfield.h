@@ -18,8 +18,10 @@
 ****************************************************************************************/
 
 #pragma once
+#include "GlyphAtlas.h"
 #include "GraphicItem.h"
 #include <IGraphicTextfield.h>
+#include <string>
 
 namespace engine {
 	namespace graphic {
@@ -31,16 +33,36 @@ namespace engine {
 			CGraphicTextfield(const char * text, CGraphicItem * pParent = nullptr);
 			CGraphicTextfield(const CGraphicTextfield &) = delete;
 			CGraphicTextfield &operator=(const CGraphicTextfield &) = delete;
-			virtual ~CGraphicTextfield() override {};
+			virtual ~CGraphicTextfield() override { damage(); };
+
+			/**
+			 * @brief The textfields are allocated from a pool of the framework
+			 */
+			static void * operator new(size_t size);
+			static void operator delete(void * pTextfield);
 
 			const char * text() override { return m_text.c_str(); }
 			void setText(const char * format, ...) override;
+			void setNumber(const char * prefix, int value) override;
+
+			// CGraphicItem
+			utils::CRectangle paintRectangle() const override;
+			//~CGraphicItem
 
 		protected:
 			void draw(int x, int y) override;
 
+		private:
+			/**
+			 * @brief Replaces the text, damaging the item only if it changes
+			 */
+			void assignText(const char * text, size_t length, const char * suffix = "", size_t suffixLength = 0);
+
 		private:
 			std::string m_text;
+
+			CGlyphAtlas::TQuads m_glyphs; /* Glyphs of m_text, laid out at the first draw after a change */
+			bool m_glyphsDirty{ true };
 		};
 
 	} // namespace graphic
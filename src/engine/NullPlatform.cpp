@@ -0,0 +1,246 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#include "NullPlatform.h"
+#include <CSVReader.h>
+#include <DrawList.h>
+#include <IFramework.h>
+#include <IVariablesManager.h>
+#include <Path.h>
+#include <cassert>
+#include <cstdlib>
+#include <iostream>
+
+#include "ISystemGlobalEnvironment.h"
+extern utils::interfaces::SSystemGlobalEnvironment * g_env;
+
+namespace engine {
+    namespace platform {
+
+        static const int script_csv_cells = 4;
+        static const char * clock_virtual = "virtual";
+        static const char * clock_real = "real";
+
+        /**
+         * @brief Sprite of the CNullPlatform, which only counts how many times it is drawn
+         */
+        class CNullPlatform::CNullSprite final : public utils::interfaces::ISprite
+        {
+          public:
+            explicit CNullSprite(unsigned long long & draws) : m_draws(draws) {}
+
+            void destroy() override { delete this; }
+            void draw(int /*x*/, int /*y*/) override { ++m_draws; }
+
+          private:
+            unsigned long long & m_draws;
+        };
+
+        utils::interfaces::IVariable * CNullPlatform::variable(const char * name)
+        {
+            if ((g_env == nullptr) || (g_env->pFramework == nullptr))
+            {
+                return nullptr;
+            }
+
+            return g_env->pFramework->variablesManager()->variable(name);
+        }
+
+        bool CNullPlatform::loadScript(const char * filePath)
+        {
+            assert(filePath && filePath[0]);
+
+            utils::CCSVReader csv_reader(filePath);
+            utils::CCSVReader::TContent csv_content;
+            if (!csv_reader.readAll(csv_content))
+            {
+                std::cerr << "[ERROR] Key script " << filePath << " cannot be read" << std::endl;
+                return false;
+            }
+
+            std::vector<SScriptRow> script;
+            script.reserve(csv_content.size());
+
+            const size_t size = csv_content.size();
+            for (size_t line = 0; line < size; ++line)
+            {
+                const utils::CCSVReader::TRow & csv_row = csv_content[line];
+                if (csv_row.size() != script_csv_cells)
+                {
+                    std::cerr << "[ERROR] Key script row at line " << line << " doesn't have "
+                              << script_csv_cells << " elements" << std::endl;
+                    return false;
+                }
+
+                SScriptRow row;
+                row.frame = (unsigned int)std::strtoul(csv_row[0].c_str(), nullptr, 0);
+                row.keys.fire = atoi(csv_row[1].c_str()) != 0;
+                row.keys.left = atoi(csv_row[2].c_str()) != 0;
+                row.keys.right = atoi(csv_row[3].c_str()) != 0;
+
+                if (!script.empty() && (row.frame < script.back().frame))
+                {
+                    std::cerr << "[ERROR] Key script row at line " << line
+                              << " goes back in time" << std::endl;
+                    return false;
+                }
+
+                script.push_back(row);
+            }
+
+            m_script.swap(script);
+            m_scriptRow = 0;
+            return true;
+        }
+
+        utils::interfaces::IPlatform * CNullPlatform::platform() const
+        {
+            return const_cast<CNullPlatform *>(this);
+        }
+
+        utils::interfaces::IPlatformBatch * CNullPlatform::batch() const
+        {
+            return const_cast<CNullPlatform *>(this);
+        }
+
+        void CNullPlatform::destroy()
+        {
+            if (!m_initialized)
+            {
+                return;
+            }
+
+            m_initialized = false;
+
+            const double seconds =
+                std::chrono::duration<double>(TClock::now() - m_startTime).count();
+            std::cout << "[INFO] Platform ran " << m_frames << " frames in " << seconds
+                      << " s (" << (seconds > 0.0 ? m_frames / seconds : 0.0) << " fps), "
+                      << m_spriteDraws << " sprite draws, " << m_textDraws << " text draws"
+                      << std::endl;
+        }
+
+        bool CNullPlatform::init(int /*width*/, int /*height*/)
+        {
+            if (m_initialized)
+            {
+                std::cerr << "[ERROR] null_platform is already initialized" << std::endl;
+                return false;
+            }
+
+            utils::interfaces::IVariable * p_variable = variable("sys_nullPlatformClock");
+            if (p_variable != nullptr)
+            {
+                const std::string clock = p_variable->value<std::string>();
+                if ((clock != clock_virtual) && (clock != clock_real))
+                {
+                    std::cerr << "[ERROR] Unknown null_platform clock " << clock.c_str()
+                              << std::endl;
+                    return false;
+                }
+
+                m_virtualClock = clock == clock_virtual;
+            }
+
+            p_variable = variable("sys_nullPlatformTimeStep");
+            if ((p_variable != nullptr) && (p_variable->value<float>() > 0.0f))
+            {
+                m_timeStep = p_variable->value<float>();
+            }
+
+            p_variable = variable("sys_nullPlatformFrames");
+            if (p_variable != nullptr)
+            {
+                m_frameLimit = p_variable->value<unsigned int>();
+            }
+
+            p_variable = variable("sys_nullPlatformScript");
+            if ((p_variable != nullptr) && !p_variable->value<std::string>().empty())
+            {
+                const std::string script_file =
+                    utils::path_utils::executablePath() + "/" + p_variable->value<std::string>();
+                if (!loadScript(script_file.c_str()))
+                {
+                    return false;
+                }
+            }
+
+            m_frames = 0;
+            m_spriteDraws = 0;
+            m_textDraws = 0;
+            m_startTime = TClock::now();
+            m_initialized = true;
+            return true;
+        }
+
+        bool CNullPlatform::update()
+        {
+            if ((m_frameLimit > 0) && (m_frames >= m_frameLimit))
+            {
+                return false;
+            }
+
+            while ((m_scriptRow < m_script.size()) && (m_script[m_scriptRow].frame <= m_frames))
+            {
+                m_keys = m_script[m_scriptRow].keys;
+                ++m_scriptRow;
+            }
+
+            ++m_frames;
+            return true;
+        }
+
+        utils::interfaces::ISprite * CNullPlatform::createSprite(const char * name)
+        {
+            assert(name && name[0]);
+            return new CNullSprite(m_spriteDraws);
+        }
+
+        void CNullPlatform::drawText(int /*x*/, int /*y*/, const char * /*msg*/) { ++m_textDraws; }
+
+        float CNullPlatform::getElapsedTime()
+        {
+            if (m_virtualClock)
+            {
+                return m_frames * m_timeStep;
+            }
+
+            return std::chrono::duration<float>(TClock::now() - m_startTime).count();
+        }
+
+        void CNullPlatform::getKeyStatus(key_status & keys) { keys = m_keys; }
+
+        void CNullPlatform::submit(const utils::CDrawList & drawList)
+        {
+            for (const utils::CDrawList::SCommand & command : drawList.commands())
+            {
+                // The glyphs are copied from the atlas like the sprites
+                if (command.type == utils::CDrawList::command_type::text)
+                {
+                    ++m_textDraws;
+                }
+                else
+                {
+                    ++m_spriteDraws;
+                }
+            }
+        }
+
+    } // namespace platform
+} // namespace engine
@@ -0,0 +1,124 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#pragma once
+#include <IPlatform.h>
+#include <IPlatformBatch.h>
+#include <IPlatformManager.h>
+#include <chrono>
+#include <vector>
+
+namespace utils {
+    namespace interfaces {
+        struct IVariable;
+    }
+}
+
+namespace engine {
+    namespace platform {
+
+        /**
+         * @brief CNullPlatform is a headless platform which draws nothing, so the framework runs
+         * as fast as the engine and the game allow. It only counts the draw calls and plays the
+         * key states of a script, which makes it fit for benchmarks and unattended runs.
+         * It is configured by the following system variables, all optional:
+         * - sys_nullPlatformClock: "virtual" advances the time by a fixed step each frame, so
+         *   runs are deterministic; "real" reports the time actually elapsed since init
+         * - sys_nullPlatformTimeStep: step of the virtual clock, in seconds
+         * - sys_nullPlatformFrames: number of frames after which update returns false, 0 never
+         * - sys_nullPlatformScript: CSV file next to the executable, one "frame;fire;left;right"
+         *   row per change of the keys. The keys keep their state until the next row
+         */
+        class CNullPlatform : public utils::interfaces::IPlatformManager,
+                              public utils::interfaces::IPlatform,
+                              public utils::interfaces::IPlatformBatch
+        {
+          public:
+            CNullPlatform() = default;
+            CNullPlatform(const CNullPlatform &) = delete;
+            CNullPlatform & operator=(const CNullPlatform &) = delete;
+
+            inline unsigned int frames() const { return m_frames; }
+            inline unsigned long long spriteDraws() const { return m_spriteDraws; }
+            inline unsigned long long textDraws() const { return m_textDraws; }
+
+            /**
+             * @brief Loads the key script from the given file. Returns false if the file cannot
+             * be read or its rows are not valid
+             */
+            bool loadScript(const char * filePath);
+
+            // IPlatformManager
+            utils::interfaces::IPlatform * platform() const override;
+            utils::interfaces::IPlatformBatch * batch() const override;
+            //~IPlatformManager
+
+            // IPlatform
+            void destroy() override;
+            bool init(int width, int height) override;
+            bool update() override;
+            utils::interfaces::ISprite * createSprite(const char * name) override;
+            void drawText(int x, int y, const char * msg) override;
+            float getElapsedTime() override;
+            void getKeyStatus(key_status & keys) override;
+            //~IPlatform
+
+            // IPlatformBatch
+            void submit(const utils::CDrawList & drawList) override;
+            bool setAtlas(const utils::CBitmapImage & /*atlas*/) override { return true; }
+            //~IPlatformBatch
+
+          protected:
+            inline bool isInitialized() const { return m_initialized; }
+            inline void countSpriteDraw() { ++m_spriteDraws; }
+
+            /**
+             * @brief Retrieves the system variable with the given name, nullptr if it is not set
+             */
+            static utils::interfaces::IVariable * variable(const char * name);
+
+          private:
+            class CNullSprite;
+
+            struct SScriptRow
+            {
+                unsigned int frame{0};
+                key_status keys;
+            };
+
+            typedef std::chrono::steady_clock TClock;
+
+          private:
+            bool m_initialized{false};
+            bool m_virtualClock{true};
+            float m_timeStep{1.0f / 60.0f};
+            unsigned int m_frameLimit{0};
+
+            unsigned int m_frames{0};
+            unsigned long long m_spriteDraws{0};
+            unsigned long long m_textDraws{0};
+            TClock::time_point m_startTime;
+
+            std::vector<SScriptRow> m_script;
+            size_t m_scriptRow{0}; /* Next row of m_script to apply */
+            key_status m_keys;
+        };
+
+    } // namespace platform
+} // namespace engine
@@ -17,9 +17,16 @@
 **
 ****************************************************************************************/
 
-#include "EasyPlatform.h"
+#include "NullPlatform.h"
 #include "PlatformFactory.h"
+#include "SoftwarePlatform.h"
 #include <cassert>
+#include <cstring>
+#include <iostream>
+
+#if defined(_WIN32)
+#include "EasyPlatform.h"
+#endif
 
 namespace engine {
     namespace platform {
@@ -28,11 +35,24 @@ namespace engine {
         {
             assert(platformName && platformName[0]);
 
+#if defined(_WIN32)
             if (strcmp(platformName, "win_platform") == 0)
             {
                 return new CEasyPlatform();
             }
+#endif
+
+            if (strcmp(platformName, "null_platform") == 0)
+            {
+                return new CNullPlatform();
+            }
+
+            if (strcmp(platformName, "software_platform") == 0)
+            {
+                return new CSoftwarePlatform();
+            }
 
+            std::cerr << "[ERROR] Platform " << platformName << " is not available" << std::endl;
             return nullptr;
         }
 
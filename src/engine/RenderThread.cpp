@@ -0,0 +1,113 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#include "RenderThread.h"
+#include <IPlatformBatch.h>
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+
+namespace engine {
+
+    CRenderThread::CRenderThread(utils::interfaces::IPlatformBatch * pBatch, unsigned int buffers)
+        : m_pBatch(pBatch), m_drawLists(std::max(2u, buffers))
+    {
+        assert(m_pBatch);
+
+        for (utils::CDrawList & draw_list : m_drawLists)
+        {
+            m_freeLists.push_back(&draw_list);
+        }
+
+        m_thread = std::thread(&CRenderThread::renderMain, this);
+    }
+
+    CRenderThread::~CRenderThread()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_quit = true;
+        }
+        m_queuedCondition.notify_one();
+        m_thread.join();
+
+        std::cout << "[INFO] Render thread rendered " << m_frames << " frames with "
+                  << m_drawLists.size() << " draw lists, the main thread waited " << m_waitSeconds
+                  << " s for them" << std::endl;
+    }
+
+    utils::CDrawList & CRenderThread::acquire()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_freeLists.empty())
+        {
+            const auto start_time = std::chrono::steady_clock::now();
+            m_freeCondition.wait(lock, [this] { return !m_freeLists.empty(); });
+            m_waitSeconds +=
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time)
+                    .count();
+        }
+
+        utils::CDrawList * p_draw_list = m_freeLists.front();
+        m_freeLists.pop_front();
+        return *p_draw_list;
+    }
+
+    void CRenderThread::submit(utils::CDrawList & drawList)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queuedLists.push_back(&drawList);
+        }
+        m_queuedCondition.notify_one();
+    }
+
+    void CRenderThread::renderMain()
+    {
+        for (;;)
+        {
+            utils::CDrawList * p_draw_list = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_queuedCondition.wait(lock, [this] { return m_quit || !m_queuedLists.empty(); });
+
+                // The lists queued before the stop are still rendered
+                if (m_queuedLists.empty())
+                {
+                    return;
+                }
+
+                p_draw_list = m_queuedLists.front();
+                m_queuedLists.pop_front();
+            }
+
+            m_pBatch->submit(*p_draw_list);
+            p_draw_list->clear();
+            ++m_frames;
+
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_freeLists.push_back(p_draw_list);
+            }
+            m_freeCondition.notify_one();
+        }
+    }
+
+} // namespace engine
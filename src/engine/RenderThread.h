@@ -0,0 +1,91 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#pragma once
+#include <DrawList.h>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utils {
+    namespace interfaces {
+        struct IPlatformBatch;
+    }
+}
+
+namespace engine {
+
+    /**
+     * @brief CRenderThread hands the draw lists of the frames to the platform on a thread of its
+     * own, so the simulation of a frame overlaps the rendering of the previous one. The lists are
+     * cycled through a fixed set of buffers: the main thread fills a free list, queues it, and
+     * only waits when all the other buffers are still queued or being rendered
+     */
+    class CRenderThread final
+    {
+      public:
+        /**
+         * @brief Starts the thread submitting the lists to pBatch, with 2 (double buffering) or
+         * more draw lists
+         */
+        CRenderThread(utils::interfaces::IPlatformBatch * pBatch, unsigned int buffers);
+
+        /**
+         * @brief Renders the lists still queued and stops the thread
+         */
+        ~CRenderThread();
+
+        CRenderThread(const CRenderThread &) = delete;
+        CRenderThread & operator=(const CRenderThread &) = delete;
+
+        /**
+         * @brief Retrieves an empty list to fill, waiting for the render thread to release one
+         * if needed
+         */
+        utils::CDrawList & acquire();
+
+        /**
+         * @brief Queues a list retrieved with acquire() for rendering. The list must not be
+         * touched afterwards
+         */
+        void submit(utils::CDrawList & drawList);
+
+      private:
+        void renderMain();
+
+      private:
+        utils::interfaces::IPlatformBatch * m_pBatch{nullptr};
+
+        std::vector<utils::CDrawList> m_drawLists;
+        std::deque<utils::CDrawList *> m_freeLists;
+        std::deque<utils::CDrawList *> m_queuedLists;
+
+        std::mutex m_mutex;
+        std::condition_variable m_queuedCondition;
+        std::condition_variable m_freeCondition;
+        bool m_quit{false};
+        std::thread m_thread;
+
+        unsigned int m_frames{0};
+        double m_waitSeconds{0.0}; /* Time the main thread spent waiting for a free list */
+    };
+
+} // namespace engine
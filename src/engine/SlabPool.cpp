@@ -0,0 +1,86 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#include "SlabPool.h"
+#include <algorithm>
+#include <cassert>
+#include <new>
+
+namespace engine {
+
+    // Blocks aligned as the ones of the operator new, so they can hold any object
+    static const size_t block_alignment = alignof(std::max_align_t);
+
+    CSlabPool::CSlabPool(size_t blockSize, size_t blocksPerSlab)
+        : m_blockSize((std::max(blockSize, sizeof(SFreeBlock)) + block_alignment - 1) /
+                      block_alignment * block_alignment)
+        , m_blocksPerSlab(blocksPerSlab)
+    {
+        assert(blockSize > 0);
+        assert(blocksPerSlab > 0);
+    }
+
+    CSlabPool::~CSlabPool()
+    {
+        for (void * p_slab : m_slabs)
+        {
+            ::operator delete(p_slab);
+        }
+    }
+
+    void * CSlabPool::allocate()
+    {
+        if (m_pFreeBlocks == nullptr)
+        {
+            m_slabs.reserve(m_slabs.size() + 1);
+            char * p_slab = static_cast<char *>(::operator new(m_blockSize * m_blocksPerSlab));
+            m_slabs.push_back(p_slab);
+
+            // Chained backwards, so the blocks are handed out in the order of their addresses
+            for (size_t i = m_blocksPerSlab; i > 0; --i)
+            {
+                auto * p_block = reinterpret_cast<SFreeBlock *>(p_slab + (i - 1) * m_blockSize);
+                p_block->pNext = m_pFreeBlocks;
+                m_pFreeBlocks = p_block;
+            }
+        }
+
+        SFreeBlock * p_block = m_pFreeBlocks;
+        m_pFreeBlocks = p_block->pNext;
+        ++m_allocatedBlocks;
+
+        return p_block;
+    }
+
+    void CSlabPool::release(void * pBlock)
+    {
+        if (pBlock == nullptr)
+        {
+            return;
+        }
+
+        assert(m_allocatedBlocks > 0);
+
+        auto * p_block = static_cast<SFreeBlock *>(pBlock);
+        p_block->pNext = m_pFreeBlocks;
+        m_pFreeBlocks = p_block;
+        --m_allocatedBlocks;
+    }
+
+} // namespace engine
@@ -0,0 +1,73 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#pragma once
+#include <cstddef>
+#include <vector>
+
+namespace engine {
+
+    /**
+     * @brief CSlabPool hands out blocks of a fixed size carved from slabs of several blocks, so
+     * objects allocated and released at a steady rate reuse the same memory instead of going
+     * through the heap each time. The released blocks are chained in a free list stored in the
+     * blocks themselves. The slabs are only returned to the heap when the pool is destroyed, so
+     * all the blocks must have been released by then
+     */
+    class CSlabPool final
+    {
+      public:
+        /**
+         * @brief Creates a pool of blocks of blockSize bytes, allocated blocksPerSlab at a time
+         */
+        explicit CSlabPool(size_t blockSize, size_t blocksPerSlab = 64);
+        ~CSlabPool();
+
+        CSlabPool(const CSlabPool &) = delete;
+        CSlabPool & operator=(const CSlabPool &) = delete;
+
+        inline size_t blockSize() const noexcept { return m_blockSize; }
+        inline size_t allocatedBlocks() const noexcept { return m_allocatedBlocks; }
+        inline size_t slabs() const noexcept { return m_slabs.size(); }
+
+        /**
+         * @brief Retrieves a block, adding a slab when none is free. Throws std::bad_alloc as
+         * the operator new if the slab cannot be allocated
+         */
+        void * allocate();
+
+        /**
+         * @brief Gives back a block retrieved with allocate()
+         */
+        void release(void * pBlock);
+
+      private:
+        struct SFreeBlock
+        {
+            SFreeBlock * pNext;
+        };
+
+        size_t m_blockSize;
+        size_t m_blocksPerSlab;
+        std::vector<void *> m_slabs;
+        SFreeBlock * m_pFreeBlocks{nullptr};
+        size_t m_allocatedBlocks{0};
+    };
+
+} // namespace engine
@@ -0,0 +1,699 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#include "SoftwarePlatform.h"
+#include <BitmapFont.h>
+#include <DrawList.h>
+#include <IVariable.h>
+#include <Path.h>
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SOFTWARE_PLATFORM_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(SOFTWARE_PLATFORM_X86) && defined(__GNUC__)
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE2
+#define TARGET_AVX2
+#endif
+
+namespace engine {
+    namespace platform {
+
+        static const std::uint32_t clear_color = 0xFF000000u;
+        static const std::uint32_t text_color = 0xFFFFFFFFu;
+        static const int default_tile_size = 64;
+
+        static const char * simd_auto = "auto";
+        static const char * simd_avx2 = "avx2";
+        static const char * simd_sse2 = "sse2";
+        static const char * simd_scalar = "scalar";
+
+        /**
+         * @brief Color key blit kernels: each source pixel with a zero alpha leaves the
+         * destination pixel untouched, any other replaces it
+         */
+        static void blitScalar(std::uint32_t * pDestination, const std::uint32_t * pSource, int count)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                if ((pSource[i] & utils::CBitmapImage::alpha_mask) != 0)
+                {
+                    pDestination[i] = pSource[i];
+                }
+            }
+        }
+
+#if defined(SOFTWARE_PLATFORM_X86)
+        TARGET_SSE2 static void blitSse2(std::uint32_t * pDestination,
+                                         const std::uint32_t * pSource,
+                                         int count)
+        {
+            const __m128i alpha = _mm_set1_epi32((int)utils::CBitmapImage::alpha_mask);
+            const __m128i zero = _mm_setzero_si128();
+
+            int i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                const __m128i source = _mm_loadu_si128((const __m128i *)(pSource + i));
+                const __m128i destination = _mm_loadu_si128((const __m128i *)(pDestination + i));
+                const __m128i transparent = _mm_cmpeq_epi32(_mm_and_si128(source, alpha), zero);
+                const __m128i result = _mm_or_si128(_mm_and_si128(transparent, destination),
+                                                    _mm_andnot_si128(transparent, source));
+                _mm_storeu_si128((__m128i *)(pDestination + i), result);
+            }
+
+            blitScalar(pDestination + i, pSource + i, count - i);
+        }
+
+        TARGET_AVX2 static void blitAvx2(std::uint32_t * pDestination,
+                                         const std::uint32_t * pSource,
+                                         int count)
+        {
+            const __m256i alpha = _mm256_set1_epi32((int)utils::CBitmapImage::alpha_mask);
+            const __m256i zero = _mm256_setzero_si256();
+
+            int i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                const __m256i source = _mm256_loadu_si256((const __m256i *)(pSource + i));
+                const __m256i destination =
+                    _mm256_loadu_si256((const __m256i *)(pDestination + i));
+                const __m256i transparent =
+                    _mm256_cmpeq_epi32(_mm256_and_si256(source, alpha), zero);
+                _mm256_storeu_si256((__m256i *)(pDestination + i),
+                                    _mm256_blendv_epi8(source, destination, transparent));
+            }
+
+            blitSse2(pDestination + i, pSource + i, count - i);
+        }
+
+        static bool cpuSupportsAvx2()
+        {
+#if defined(__GNUC__)
+            return __builtin_cpu_supports("avx2") != 0;
+#elif defined(_MSC_VER)
+            int registers[4] = {0};
+            __cpuid(registers, 1);
+            const bool os_saves_avx = (registers[2] & (1 << 27)) && (registers[2] & (1 << 28)) &&
+                                      ((_xgetbv(0) & 0x6) == 0x6);
+            if (!os_saves_avx)
+            {
+                return false;
+            }
+
+            __cpuidex(registers, 7, 0);
+            return (registers[1] & (1 << 5)) != 0;
+#else
+            return false;
+#endif
+        }
+#endif
+
+        /**
+         * @brief Sprite of the CSoftwarePlatform, which records its draws in the platform
+         */
+        class CSoftwarePlatform::CSoftwareSprite final : public utils::interfaces::ISprite
+        {
+          public:
+            CSoftwareSprite(CSoftwarePlatform * pPlatform, std::uint32_t image)
+                : m_pPlatform(pPlatform), m_image(image)
+            {
+            }
+
+            inline std::uint32_t image() const { return m_image; }
+
+            void destroy() override { delete this; }
+            void draw(int x, int y) override { m_pPlatform->drawSprite(m_image, x, y); }
+
+          private:
+            CSoftwarePlatform * m_pPlatform;
+            std::uint32_t m_image;
+        };
+
+        CSoftwarePlatform::~CSoftwarePlatform() { stopWorkers(); }
+
+        void CSoftwarePlatform::destroy()
+        {
+            if (!isInitialized())
+            {
+                return;
+            }
+
+            stopWorkers();
+
+            if (!m_capturePath.empty() && !m_framebuffer.save(m_capturePath.c_str()))
+            {
+                std::cerr << "[ERROR] Frame cannot be saved to " << m_capturePath.c_str()
+                          << std::endl;
+            }
+
+            const double pixels =
+                (double)m_framebuffer.width() * m_framebuffer.height() * m_rasterizedFrames;
+            std::cout << "[INFO] software_platform rasterized " << m_rasterizedFrames
+                      << " frames of " << m_framebuffer.width() << "x" << m_framebuffer.height()
+                      << " in " << m_rasterSeconds << " s ("
+                      << (m_rasterSeconds > 0.0 ? m_redrawnPixels / m_rasterSeconds / 1e6 : 0.0)
+                      << " Mpixel/s) with " << m_threads << " threads, "
+                      << m_blitName << " blits, "
+                      << (pixels > 0.0 ? m_redrawnPixels * 100.0 / pixels : 0.0)
+                      << "% of the pixels redrawn" << std::endl;
+
+            CNullPlatform::destroy();
+        }
+
+        bool CSoftwarePlatform::init(int width, int height)
+        {
+            if ((width <= 0) || (height <= 0))
+            {
+                std::cerr << "[ERROR] software_platform cannot open a " << width << "x" << height
+                          << " window" << std::endl;
+                return false;
+            }
+
+            if (!CNullPlatform::init(width, height))
+            {
+                return false;
+            }
+
+            std::string simd = simd_auto;
+            utils::interfaces::IVariable * p_variable = variable("sys_softwarePlatformSimd");
+            if (p_variable != nullptr)
+            {
+                simd = p_variable->value<std::string>();
+            }
+
+            m_blit = blitScalar;
+            m_blitName = simd_scalar;
+#if defined(SOFTWARE_PLATFORM_X86)
+            const bool avx2 = cpuSupportsAvx2();
+            if ((simd == simd_avx2 && avx2) || (simd == simd_auto && avx2))
+            {
+                m_blit = blitAvx2;
+                m_blitName = simd_avx2;
+            }
+            else if (simd == simd_sse2 || simd == simd_auto)
+            {
+                m_blit = blitSse2;
+                m_blitName = simd_sse2;
+            }
+#endif
+            if ((simd != simd_auto) && (simd != m_blitName))
+            {
+                std::cerr << "[ERROR] Blit kernel " << simd.c_str() << " is not available"
+                          << std::endl;
+                return false;
+            }
+
+            m_tileSize = default_tile_size;
+            p_variable = variable("sys_softwarePlatformTileSize");
+            if ((p_variable != nullptr) && (p_variable->value<unsigned int>() > 0))
+            {
+                m_tileSize = (int)p_variable->value<unsigned int>();
+            }
+
+            unsigned int threads = 0;
+            p_variable = variable("sys_softwarePlatformThreads");
+            if (p_variable != nullptr)
+            {
+                threads = p_variable->value<unsigned int>();
+            }
+
+            if (threads == 0)
+            {
+                threads = std::max(1u, std::thread::hardware_concurrency());
+            }
+
+            p_variable = variable("sys_softwarePlatformCapture");
+            if ((p_variable != nullptr) && !p_variable->value<std::string>().empty())
+            {
+                m_capturePath =
+                    utils::path_utils::executablePath() + "/" + p_variable->value<std::string>();
+            }
+
+            m_framebuffer = utils::CBitmapImage(width, height, clear_color);
+            m_tileColumns = (width + m_tileSize - 1) / m_tileSize;
+            m_tileRows = (height + m_tileSize - 1) / m_tileSize;
+            m_bins.assign(m_tileColumns * m_tileRows, TBin());
+            m_tileDamaged.assign(m_bins.size(), 0);
+            m_fullRedraw = true;
+
+            // The thread calling update renders tiles as well
+            m_threads = threads;
+            m_quit = false;
+            for (unsigned int i = 1; i < threads; ++i)
+            {
+                m_workers.emplace_back(&CSoftwarePlatform::workerMain, this);
+            }
+
+            m_rasterizedFrames = 0;
+            m_rasterSeconds = 0.0;
+            m_redrawnPixels = 0.0;
+            return true;
+        }
+
+        bool CSoftwarePlatform::update()
+        {
+            // The draw lists are rendered when submitted, only the direct draws are left
+            if (isInitialized() && !m_batched)
+            {
+                std::lock_guard<std::mutex> lock(m_renderMutex);
+                rasterize();
+            }
+
+            return CNullPlatform::update();
+        }
+
+        utils::interfaces::ISprite * CSoftwarePlatform::createSprite(const char * name)
+        {
+            assert(name && name[0]);
+
+            std::lock_guard<std::mutex> lock(m_renderMutex);
+            auto it = m_imageIndices.find(name);
+            if (it == m_imageIndices.end())
+            {
+                utils::CBitmapImage image;
+                const std::string path = utils::path_utils::executablePath() + "/" + name;
+                if (!image.load(path.c_str()))
+                {
+                    std::cerr << "[ERROR] Sprite image " << path.c_str() << " cannot be loaded"
+                              << std::endl;
+                    return nullptr;
+                }
+
+                m_images.push_back(std::move(image));
+                it = m_imageIndices.insert(std::make_pair(std::string(name),
+                                                          (std::uint32_t)(m_images.size() - 1)))
+                         .first;
+            }
+
+            return new CSoftwareSprite(this, it->second);
+        }
+
+        void CSoftwarePlatform::drawText(int x, int y, const char * msg)
+        {
+            assert(msg);
+
+            std::lock_guard<std::mutex> lock(m_renderMutex);
+            CNullPlatform::drawText(x, y, msg);
+            recordText(x, y, msg);
+
+            // The draws outside a draw list come without damage
+            m_fullRedraw = true;
+        }
+
+        void CSoftwarePlatform::submit(const utils::CDrawList & drawList)
+        {
+            std::lock_guard<std::mutex> lock(m_renderMutex);
+            CNullPlatform::submit(drawList);
+
+            if (drawList.isFullRedraw())
+            {
+                m_fullRedraw = true;
+            }
+            else
+            {
+                for (const utils::CRectangle & rectangle : drawList.damage())
+                {
+                    damageTiles(rectangle);
+                }
+            }
+
+            // All the sprites of the list have been created by this platform
+            for (const utils::CDrawList::SCommand & command : drawList.commands())
+            {
+                if ((command.type != utils::CDrawList::command_type::text) && m_hasAtlas &&
+                    (command.atlasWidth > 0))
+                {
+                    recordSprite(m_atlasImage,
+                                 command.x,
+                                 command.y,
+                                 utils::CRectangle(command.atlasX,
+                                                   command.atlasY,
+                                                   command.atlasWidth,
+                                                   command.atlasHeight));
+                }
+                else if (command.type == utils::CDrawList::command_type::sprite)
+                {
+                    const auto * p_sprite = static_cast<const CSoftwareSprite *>(command.pSprite);
+                    recordSprite(p_sprite->image(), command.x, command.y);
+                }
+                else if (command.type == utils::CDrawList::command_type::glyph)
+                {
+                    const char glyph_text[2] = {command.character, '\0'};
+                    recordText(command.x, command.y, glyph_text);
+                }
+                else
+                {
+                    recordText(command.x, command.y, drawList.text(command));
+                }
+            }
+
+            rasterize();
+            m_batched = true;
+        }
+
+        void CSoftwarePlatform::recordText(int x, int y, const char * msg)
+        {
+            const utils::CSize size = utils::CBitmapFont::textSize(msg);
+
+            SCommand command;
+            command.type = command_type::text;
+            command.x = x;
+            command.y = y;
+            command.width = (int)size.width();
+            command.height = (int)size.height();
+            command.index = (std::uint32_t)m_texts.size();
+            m_commands.push_back(command);
+
+            m_texts.insert(m_texts.end(), msg, msg + strlen(msg) + 1);
+        }
+
+        void CSoftwarePlatform::drawSprite(std::uint32_t image, int x, int y)
+        {
+            std::lock_guard<std::mutex> lock(m_renderMutex);
+            countSpriteDraw();
+            recordSprite(image, x, y);
+            m_fullRedraw = true;
+        }
+
+        void CSoftwarePlatform::damageTiles(const utils::CRectangle & rectangle)
+        {
+            const int left = std::max(0, (int)std::floor(rectangle.x()));
+            const int top = std::max(0, (int)std::floor(rectangle.y()));
+            const int right =
+                std::min(m_framebuffer.width(), (int)std::ceil(rectangle.x() + rectangle.width()));
+            const int bottom = std::min(m_framebuffer.height(),
+                                        (int)std::ceil(rectangle.y() + rectangle.height()));
+            if ((left >= right) || (top >= bottom))
+            {
+                return;
+            }
+
+            for (int row = top / m_tileSize; row <= (bottom - 1) / m_tileSize; ++row)
+            {
+                for (int column = left / m_tileSize; column <= (right - 1) / m_tileSize; ++column)
+                {
+                    m_tileDamaged[row * m_tileColumns + column] = 1;
+                }
+            }
+        }
+
+        bool CSoftwarePlatform::setAtlas(const utils::CBitmapImage & atlas)
+        {
+            if (atlas.isNull())
+            {
+                return false;
+            }
+
+            std::lock_guard<std::mutex> lock(m_renderMutex);
+            if (m_hasAtlas)
+            {
+                m_images[m_atlasImage] = atlas;
+            }
+            else
+            {
+                m_images.push_back(atlas);
+                m_atlasImage = (std::uint32_t)(m_images.size() - 1);
+                m_hasAtlas = true;
+            }
+
+            return true;
+        }
+
+        void CSoftwarePlatform::recordSprite(std::uint32_t image, int x, int y)
+        {
+            const utils::CBitmapImage & source = m_images[image];
+            recordSprite(image, x, y, utils::CRectangle(0, 0, source.width(), source.height()));
+        }
+
+        void CSoftwarePlatform::recordSprite(std::uint32_t image,
+                                             int x,
+                                             int y,
+                                             const utils::CRectangle & source)
+        {
+            SCommand command;
+            command.type = command_type::sprite;
+            command.x = x;
+            command.y = y;
+            command.width = (int)source.width();
+            command.height = (int)source.height();
+            command.sourceX = (int)source.x();
+            command.sourceY = (int)source.y();
+            command.index = image;
+            m_commands.push_back(command);
+        }
+
+        void CSoftwarePlatform::rasterize()
+        {
+            const auto start_time = std::chrono::steady_clock::now();
+
+            if (m_fullRedraw)
+            {
+                std::fill(m_tileDamaged.begin(), m_tileDamaged.end(), 1);
+            }
+
+            m_damagedTiles.clear();
+            const size_t tiles = m_bins.size();
+            for (size_t tile = 0; tile < tiles; ++tile)
+            {
+                m_bins[tile].clear();
+                if (m_tileDamaged[tile] != 0)
+                {
+                    m_damagedTiles.push_back((std::uint32_t)tile);
+                }
+            }
+
+            const size_t commands = m_commands.size();
+            for (size_t i = 0; i < commands; ++i)
+            {
+                const SCommand & command = m_commands[i];
+                if ((command.x + command.width <= 0) || (command.y + command.height <= 0) ||
+                    (command.x >= m_framebuffer.width()) || (command.y >= m_framebuffer.height()))
+                {
+                    continue;
+                }
+
+                const int first_column = std::max(0, command.x) / m_tileSize;
+                const int first_row = std::max(0, command.y) / m_tileSize;
+                const int last_column =
+                    std::min(m_tileColumns - 1, (command.x + command.width - 1) / m_tileSize);
+                const int last_row =
+                    std::min(m_tileRows - 1, (command.y + command.height - 1) / m_tileSize);
+
+                for (int row = first_row; row <= last_row; ++row)
+                {
+                    for (int column = first_column; column <= last_column; ++column)
+                    {
+                        const int tile = row * m_tileColumns + column;
+                        if (m_tileDamaged[tile] != 0)
+                        {
+                            m_bins[tile].push_back((std::uint32_t)i);
+                        }
+                    }
+                }
+            }
+
+            // Nothing changed since the last frame, the framebuffer is already up to date
+            const bool parallel = !m_workers.empty() && !m_damagedTiles.empty();
+
+            m_nextTile = 0;
+            if (parallel)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                ++m_generation;
+                m_busyWorkers = m_workers.size();
+            }
+            m_wakeCondition.notify_all();
+
+            renderTiles();
+
+            if (parallel)
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_doneCondition.wait(lock, [this] { return m_busyWorkers == 0; });
+            }
+
+            m_commands.clear();
+            m_texts.clear();
+
+            for (std::uint32_t tile : m_damagedTiles)
+            {
+                const int left = (int)(tile % m_tileColumns) * m_tileSize;
+                const int top = (int)(tile / m_tileColumns) * m_tileSize;
+                const int right = std::min(left + m_tileSize, m_framebuffer.width());
+                const int bottom = std::min(top + m_tileSize, m_framebuffer.height());
+                m_redrawnPixels += (double)(right - left) * (bottom - top);
+                m_tileDamaged[tile] = 0;
+            }
+
+            m_fullRedraw = false;
+            ++m_rasterizedFrames;
+            m_rasterSeconds +=
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time)
+                    .count();
+        }
+
+        void CSoftwarePlatform::renderTiles()
+        {
+            const size_t tiles = m_damagedTiles.size();
+            for (size_t i = m_nextTile++; i < tiles; i = m_nextTile++)
+            {
+                renderTile(m_damagedTiles[i]);
+            }
+        }
+
+        void CSoftwarePlatform::renderTile(size_t tile)
+        {
+            const int left = (int)(tile % m_tileColumns) * m_tileSize;
+            const int top = (int)(tile / m_tileColumns) * m_tileSize;
+            const int right = std::min(left + m_tileSize, m_framebuffer.width());
+            const int bottom = std::min(top + m_tileSize, m_framebuffer.height());
+
+            for (int y = top; y < bottom; ++y)
+            {
+                std::uint32_t * p_line = m_framebuffer.scanLine(y);
+                std::fill(p_line + left, p_line + right, clear_color);
+            }
+
+            for (std::uint32_t index : m_bins[tile])
+            {
+                const SCommand & command = m_commands[index];
+                if (command.type == command_type::text)
+                {
+                    renderText(command, left, top, right, bottom);
+                    continue;
+                }
+
+                // Sprites are clipped to the tile, so the framebuffer borders clip them as well
+                const utils::CBitmapImage & image = m_images[command.index];
+                const int x0 = std::max(left, command.x);
+                const int y0 = std::max(top, command.y);
+                const int x1 = std::min(right, command.x + command.width);
+                const int y1 = std::min(bottom, command.y + command.height);
+
+                for (int y = y0; y < y1; ++y)
+                {
+                    m_blit(m_framebuffer.scanLine(y) + x0,
+                           image.scanLine(command.sourceY + y - command.y) + command.sourceX +
+                               (x0 - command.x),
+                           x1 - x0);
+                }
+            }
+        }
+
+        void CSoftwarePlatform::renderText(const SCommand & command,
+                                           int left,
+                                           int top,
+                                           int right,
+                                           int bottom)
+        {
+            int pen_x = command.x;
+            int pen_y = command.y;
+            for (const char * p_char = &m_texts[command.index]; *p_char != '\0'; ++p_char)
+            {
+                if (*p_char == '\n')
+                {
+                    pen_x = command.x;
+                    pen_y += utils::CBitmapFont::line_height;
+                    continue;
+                }
+
+                const std::uint8_t * p_glyph = utils::CBitmapFont::glyph(*p_char);
+                const int y0 = std::max(top, pen_y);
+                const int y1 = std::min(bottom, pen_y + utils::CBitmapFont::glyph_height);
+                const int x0 = std::max(left, pen_x);
+                const int x1 = std::min(right, pen_x + utils::CBitmapFont::glyph_width);
+
+                for (int y = y0; y < y1; ++y)
+                {
+                    const std::uint8_t bits = p_glyph[y - pen_y];
+                    std::uint32_t * p_line = m_framebuffer.scanLine(y);
+                    for (int x = x0; x < x1; ++x)
+                    {
+                        if (bits & (0x10 >> (x - pen_x)))
+                        {
+                            p_line[x] = text_color;
+                        }
+                    }
+                }
+
+                pen_x += utils::CBitmapFont::advance;
+            }
+        }
+
+        void CSoftwarePlatform::workerMain()
+        {
+            unsigned int generation = 0;
+            for (;;)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_wakeCondition.wait(lock, [this, generation] {
+                        return m_quit || (m_generation != generation);
+                    });
+
+                    if (m_quit)
+                    {
+                        return;
+                    }
+
+                    generation = m_generation;
+                }
+
+                renderTiles();
+
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (--m_busyWorkers == 0)
+                {
+                    m_doneCondition.notify_one();
+                }
+            }
+        }
+
+        void CSoftwarePlatform::stopWorkers()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_quit = true;
+            }
+            m_wakeCondition.notify_all();
+
+            for (auto & worker : m_workers)
+            {
+                worker.join();
+            }
+
+            m_workers.clear();
+        }
+
+    } // namespace platform
+} // namespace engine
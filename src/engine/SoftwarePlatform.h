@@ -0,0 +1,185 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#pragma once
+#include "NullPlatform.h"
+#include <BitmapImage.h>
+#include <Rectangle.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace engine {
+    namespace platform {
+
+        /**
+         * @brief CSoftwarePlatform renders the frames on the CPU into an in-memory framebuffer, so
+         * it gives real pixel output on machines without a GPU or a display. The sprites and the
+         * texts drawn during a frame are recorded and rasterized by update(): the frame is split
+         * into square tiles, each command is binned to the tiles it overlaps, and the tiles are
+         * rendered in parallel. The sprites are composited with color key blit kernels (AVX2,
+         * SSE2 or scalar, picked at runtime). The framebuffer is kept between the frames, so only
+         * the tiles overlapping the damage of the submitted draw lists are redrawn. A submitted draw
+         * list is rendered right away, on the thread submitting it.
+         * On top of the variables of the CNullPlatform, it is configured by the following system
+         * variables, all optional:
+         * - sys_softwarePlatformThreads: number of threads rendering the tiles, 0 for one per core
+         * - sys_softwarePlatformTileSize: side of the tiles, in pixels
+         * - sys_softwarePlatformSimd: "auto", "avx2", "sse2" or "scalar" blit kernel
+         * - sys_softwarePlatformCapture: BMP file next to the executable where the last frame is
+         *   saved when the platform is destroyed
+         */
+        class CSoftwarePlatform final : public CNullPlatform
+        {
+          public:
+            CSoftwarePlatform() = default;
+            ~CSoftwarePlatform();
+            CSoftwarePlatform(const CSoftwarePlatform &) = delete;
+            CSoftwarePlatform & operator=(const CSoftwarePlatform &) = delete;
+
+            /**
+             * @brief Retrieves the last frame rendered
+             */
+            inline const utils::CBitmapImage & framebuffer() const { return m_framebuffer; }
+
+            // IPlatform
+            void destroy() override;
+            bool init(int width, int height) override;
+            bool update() override;
+            utils::interfaces::ISprite * createSprite(const char * name) override;
+            void drawText(int x, int y, const char * msg) override;
+            //~IPlatform
+
+            // IPlatformBatch
+            void submit(const utils::CDrawList & drawList) override;
+            bool setAtlas(const utils::CBitmapImage & atlas) override;
+            //~IPlatformBatch
+
+          private:
+            class CSoftwareSprite;
+
+            typedef void (*TBlitFunction)(std::uint32_t * pDestination,
+                                          const std::uint32_t * pSource,
+                                          int count);
+
+            enum class command_type : std::uint8_t
+            {
+                sprite,
+                text
+            };
+
+            struct SCommand
+            {
+                command_type type{command_type::sprite};
+                int x{0};
+                int y{0};
+                int width{0};
+                int height{0};
+                int sourceX{0}; /* Top left corner of a sprite in its image */
+                int sourceY{0};
+                std::uint32_t index{0}; /* Image of a sprite, offset in m_texts of a text */
+            };
+
+            typedef std::vector<std::uint32_t> TBin;
+
+          private:
+            /**
+             * @brief Internal call from the CSoftwareSprite(s) to record a draw
+             */
+            void drawSprite(std::uint32_t image, int x, int y);
+
+            /**
+             * @brief Record the commands rasterized by the next update, already counted
+             */
+            void recordSprite(std::uint32_t image, int x, int y);
+            void recordSprite(std::uint32_t image, int x, int y, const utils::CRectangle & source);
+            void recordText(int x, int y, const char * msg);
+
+            /**
+             * @brief Marks the tiles overlapping the rectangle to be redrawn by the next update
+             */
+            void damageTiles(const utils::CRectangle & rectangle);
+
+            /**
+             * @brief Renders the commands recorded since the last update into the framebuffer
+             */
+            void rasterize();
+
+            /**
+             * @brief Renders damaged tiles until there are none left. Run by all the threads at
+             * once
+             */
+            void renderTiles();
+            void renderTile(size_t tile);
+            void renderText(const SCommand & command,
+                            int left,
+                            int top,
+                            int right,
+                            int bottom);
+
+            void workerMain();
+            void stopWorkers();
+
+          private:
+            utils::CBitmapImage m_framebuffer;
+            TBlitFunction m_blit{nullptr};
+            const char * m_blitName{""};
+
+            std::vector<utils::CBitmapImage> m_images;
+            std::map<std::string, std::uint32_t> m_imageIndices; /* Image of each sprite name */
+            std::uint32_t m_atlasImage{0};
+            bool m_hasAtlas{false};
+
+            std::vector<SCommand> m_commands;
+            std::vector<char> m_texts; /* Null terminated strings of the text commands */
+
+            int m_tileSize{64};
+            int m_tileColumns{0};
+            int m_tileRows{0};
+            std::vector<TBin> m_bins; /* Commands overlapping each tile, in drawing order */
+            std::vector<std::uint8_t> m_tileDamaged; /* Tiles to redraw with the next update */
+            std::vector<std::uint32_t> m_damagedTiles; /* Tiles redrawn by the current update */
+            bool m_fullRedraw{true};
+            std::atomic<size_t> m_nextTile{0};
+
+            unsigned int m_threads{1};
+            std::vector<std::thread> m_workers;
+            std::mutex m_mutex;
+            std::condition_variable m_wakeCondition;
+            std::condition_variable m_doneCondition;
+            unsigned int m_generation{0}; /* Frames handed to the workers */
+            size_t m_busyWorkers{0};
+            bool m_quit{false};
+
+            unsigned int m_rasterizedFrames{0};
+            double m_rasterSeconds{0.0};
+            double m_redrawnPixels{0.0};
+            std::string m_capturePath;
+
+            std::mutex m_renderMutex; /* Serializes the render thread and the main thread */
+            std::atomic<bool> m_batched{false}; /* A draw list has been submitted */
+        };
+
+    } // namespace platform
+} // namespace engine
@@ -27,20 +27,26 @@ extern utils::interfaces::SSystemGlobalEnvironment * g_env;
 
 namespace game {
 
-    const utils::CPicture CGame::picture_alien_1 =
-        utils::CPicture("images\\enemy1.bmp", utils::CRectangle(4, 5, 24, 22));
-    const utils::CPicture CGame::picture_alien_2 =
-        utils::CPicture("images\\enemy2.bmp", utils::CRectangle(1, 5, 30, 22));
-    const utils::CPicture CGame::picture_player =
-        utils::CPicture("images\\player.bmp", utils::CRectangle(2, 7, 28, 17));
-    const utils::CPicture CGame::picture_rocket =
-        utils::CPicture("images\\rocket.bmp", utils::CRectangle(14, 7, 4, 19));
-    const utils::CPicture CGame::picture_bomb =
-        utils::CPicture("images\\bomb.bmp", utils::CRectangle(12, 8, 8, 16));
+    utils::CPicture CGame::picture_alien_1 =
+        utils::CPicture("images/enemy1.bmp", utils::CRectangle(4, 5, 24, 22), true);
+    utils::CPicture CGame::picture_alien_2 =
+        utils::CPicture("images/enemy2.bmp", utils::CRectangle(1, 5, 30, 22), true);
+    utils::CPicture CGame::picture_player =
+        utils::CPicture("images/player.bmp", utils::CRectangle(2, 7, 28, 17), true);
+    utils::CPicture CGame::picture_rocket =
+        utils::CPicture("images/rocket.bmp", utils::CRectangle(14, 7, 4, 19), true);
+    utils::CPicture CGame::picture_bomb =
+        utils::CPicture("images/bomb.bmp", utils::CRectangle(12, 8, 8, 16), true);
 
     CGame::CGame() { resetGame(); }
 
-    CGame::~CGame() { g_env->pFramework->removeListener(this); }
+    CGame::~CGame()
+    {
+        g_env->pFramework->removeListener(this);
+
+        delete m_pState;
+        m_pState = nullptr;
+    }
 
     bool CGame::init()
     {
@@ -49,6 +55,13 @@ namespace game {
             return false;
         }
 
+        utils::CPicture * pictures[] = {
+            &picture_alien_1, &picture_alien_2, &picture_player, &picture_rocket, &picture_bomb};
+        if (!g_env->pFramework->packPictures(pictures, sizeof(pictures) / sizeof(pictures[0])))
+        {
+            return false;
+        }
+
         if (!setGameState(game_state::pregame))
         {
             return false;
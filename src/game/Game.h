@@ -40,6 +40,14 @@ namespace game {
             gameevent_health
         };
 
+        enum collision_category
+        {
+            collisioncategory_alien = 1 << 0,
+            collisioncategory_player = 1 << 1,
+            collisioncategory_rocket = 1 << 2,
+            collisioncategory_bomb = 1 << 3
+        };
+
         enum class game_state
         {
             invalid = -1,
@@ -58,11 +66,11 @@ namespace game {
         inline int score() const { return m_score; }
 
       public:
-        static const utils::CPicture picture_alien_1;
-        static const utils::CPicture picture_alien_2;
-        static const utils::CPicture picture_player;
-        static const utils::CPicture picture_rocket;
-        static const utils::CPicture picture_bomb;
+        static utils::CPicture picture_alien_1;
+        static utils::CPicture picture_alien_2;
+        static utils::CPicture picture_player;
+        static utils::CPicture picture_rocket;
+        static utils::CPicture picture_bomb;
 
       public:
         // IGame
@@ -18,17 +18,20 @@
 ****************************************************************************************/
 
 #include "Game.h"
+#include <LibraryHandler.h>
 
+#if defined(_WIN32)
 #define WIN32_LEAN_AND_MEAN
 #define NOMINMAX
 #include <windows.h>
+#endif
 
 #include "ISystemGlobalEnvironment.h"
 utils::interfaces::SSystemGlobalEnvironment * g_env = nullptr;
 
 extern "C"
 {
-    __declspec(dllexport) utils::interfaces::IGame * create_game(
+    LIBRARY_EXPORT utils::interfaces::IGame * create_game(
         utils::interfaces::SSystemGlobalEnvironment * env)
     {
         g_env = env;
@@ -36,7 +39,7 @@ extern "C"
         return g_env->pGame;
     }
 
-    __declspec(dllexport) void destroy_game()
+    LIBRARY_EXPORT void destroy_game()
     {
         if (g_env->pGame != nullptr)
         {
@@ -47,7 +50,9 @@ extern "C"
     }
 };
 
+#if defined(_WIN32)
 BOOL APIENTRY dllMain(HMODULE hModule, DWORD ul_reason_for_call, LPVOID lpReserved)
 {
     return TRUE;
 }
+#endif
@@ -22,6 +22,7 @@
 #include <IGraphicBitmap.h>
 #include <IGraphicContainer.h>
 #include <IGraphicTextfield.h>
+#include <algorithm>
 #include <cassert>
 
 #include "ISystemGlobalEnvironment.h"
@@ -49,6 +50,12 @@ namespace game {
         , VAR_KILL_SCORE_SPECIAL_VALUE(
               m_pVariables->variable("g_killScoreSpecial")->value<unsigned int>())
     {
+        // Rockets and bombs are swept by the contacts of the game area, so the simulation can run
+        // at a lower rate than the frames without passing through the aliens
+        const unsigned int simulation_rate =
+            m_pVariables->variable("g_SimulationRateHz")->value<unsigned int>();
+        m_timer.setInterval(1.0f / std::max(1u, simulation_rate));
+
         m_pContainer = g_env->pFramework->window()->addContainer();
         m_pContainer->setSize(g_env->pFramework->window()->size());
 
@@ -62,6 +69,12 @@ namespace game {
                                  (m_pContainer->size().height() - m_pGameArea->size().height()) /
                                      2);
 
+        // Aliens move together and keep their horizontal order, so the game area children stay
+        // almost sorted from one frame to the next
+        m_pGameArea->setBroadphase(
+            utils::interfaces::IGraphicContainer::broadphase_mode::sweep_and_prune);
+        m_pGameArea->addListener(this);
+
         m_aliens.reserve(VAR_ALIEN_COLUMNS_VALUE * VAR_ALIEN_ROWS_VALUE);
         for (int column = 0; column < VAR_ALIEN_COLUMNS_VALUE; ++column)
         {
@@ -69,6 +82,9 @@ namespace game {
             {
                 utils::interfaces::IGraphicBitmap * p_alien =
                     m_pGameArea->addBitmap(CGame::picture_alien_2);
+                p_alien->setCollisionCategory(CGame::collisioncategory_alien);
+                p_alien->setCollisionMask(CGame::collisioncategory_player |
+                                          CGame::collisioncategory_rocket);
                 m_aliens.push_back(p_alien);
                 p_alien->setPosition(column * CGame::picture_alien_2.size().width(),
                                     row * CGame::picture_alien_2.size().height());
@@ -76,6 +92,8 @@ namespace game {
         }
 
         m_pPlayer = m_pGameArea->addBitmap(CGame::picture_player);
+        m_pPlayer->setCollisionCategory(CGame::collisioncategory_player);
+        m_pPlayer->setCollisionMask(CGame::collisioncategory_alien | CGame::collisioncategory_bomb);
         m_pPlayer->setPosition(m_pGameArea->size().width() / 2,
                                m_pGameArea->size().height() -
                                    CGame::picture_player.size().height());
@@ -91,7 +109,8 @@ namespace game {
     CGameStateInGame::~CGameStateInGame()
     {
         m_timer.removeListener(this);
-        g_env->pFramework->window()->removeItem(m_pContainer);
+        m_pGameArea->removeListener(this);
+        delete m_pContainer;
     }
 
     bool CGameStateInGame::init()
@@ -104,9 +123,8 @@ namespace game {
 
     void CGameStateInGame::timeout()
     {
+        // Collisions with the player and the rockets are notified by the game area contacts
         checkCollisionsWithBorder();
-        checkCollisionsWithPlayer();
-        checkCollisionsWithRockets();
 
         moveAliens(m_timer.elapsed());
         moveRockets(m_timer.elapsed());
@@ -140,6 +158,8 @@ namespace game {
                     assert(m_pGameArea);
                     utils::interfaces::IGraphicBitmap * p_rocket =
                         m_pGameArea->addBitmap(CGame::picture_rocket);
+                    p_rocket->setCollisionCategory(CGame::collisioncategory_rocket);
+                    p_rocket->setCollisionMask(CGame::collisioncategory_alien);
                     m_rockets.push_back(p_rocket);
                     utils::CPoint pos = m_pPlayer->position();
                     pos.ry() -= m_pPlayer->size().height();
@@ -204,92 +224,81 @@ namespace game {
             else if (isBomb(p_item))
             {
                 utils::containers::gFindAndErase(m_bombs, p_item);
-                m_pContainer->removeItem(p_item);
+                delete p_item;
             }
         }
     }
 
-    void CGameStateInGame::checkCollisionsWithPlayer()
+    void CGameStateInGame::onContactBegin(utils::interfaces::IGraphicItem * pItem,
+                                          utils::interfaces::IGraphicItem * pOther)
     {
-        assert(m_pGameArea && m_pPlayer);
-
-        utils::interfaces::IGraphicItem::TGraphicItems collidingitems =
-            m_pGameArea->collidingItems(m_pPlayer,
-                                        utils::interfaces::IGraphicItem::collision_mode::intersect);
-
-        auto it_end = collidingitems.end();
-        for (auto it = collidingitems.begin(); it != it_end; ++it)
+        // Player and rockets both match aliens, so the pair may come in either order
+        if (isPlayer(pOther) || isRocket(pOther))
         {
-            utils::interfaces::IGraphicItem * p_item = (*it);
-
-            if (isAlien(p_item))
-            {
-                // Aliens vector simulates a bydimentional array of type aliens[ROWS][COLUMNS] so
-                // the size is kept unchanged to retrieves aliens position at wish
-                utils::containers::gFindAndReplace(m_aliens,
-                                                   p_item,
-                                                   (utils::interfaces::IGraphicItem *)nullptr);
-                delete p_item;
-            }
-            else if (isBomb(p_item))
-            {
-                utils::containers::gFindAndErase(m_bombs, p_item);
-                delete p_item;
-            }
+            std::swap(pItem, pOther);
+        }
 
-            g_env->pGame->onEvent(
-                utils::interfaces::SGameEvent(CGame::gameevent_health, VAR_HEALTH_DAMAGE_VALUE));
+        if (isPlayer(pItem))
+        {
+            collisionWithPlayer(pOther);
+        }
+        else if (isRocket(pItem))
+        {
+            collisionWithRocket(pItem, pOther);
         }
     }
 
-    void CGameStateInGame::checkCollisionsWithRockets()
+    void CGameStateInGame::collisionWithPlayer(utils::interfaces::IGraphicItem * pItem)
     {
-        assert(m_pGameArea);
-
-        auto it_rocket_end = m_rockets.end();
-        for (auto it_rocket = m_rockets.begin(); it_rocket != it_rocket_end; ++it_rocket)
+        if (isAlien(pItem))
         {
-            utils::interfaces::IGraphicItem * p_rocket = (*it_rocket);
-            utils::interfaces::IGraphicItem::TGraphicItems collidingitems =
-                m_pGameArea
-                    ->collidingItems(p_rocket,
-                                     utils::interfaces::IGraphicItem::collision_mode::intersect);
-
-            if (collidingitems.empty())
-            {
-                continue;
-            }
-
-            // Forcing rocket to collide with maximum 1 alien :))
-            utils::interfaces::IGraphicItem * p_item = collidingitems.at(0);
-
-            if (isAlien(p_item))
-            {
-                utils::containers::gFindAndReplace(m_aliens,
-                                                   p_item,
-                                                   (utils::interfaces::IGraphicItem *)nullptr);
-                delete p_item;
+            // Aliens vector simulates a bydimentional array of type aliens[ROWS][COLUMNS] so
+            // the size is kept unchanged to retrieves aliens position at wish
+            utils::containers::gFindAndReplace(m_aliens,
+                                               pItem,
+                                               (utils::interfaces::IGraphicItem *)nullptr);
+            delete pItem;
+        }
+        else if (isBomb(pItem))
+        {
+            utils::containers::gFindAndErase(m_bombs, pItem);
+            delete pItem;
+        }
 
-                (*it_rocket) = nullptr;
-                delete p_rocket;
+        g_env->pGame->onEvent(
+            utils::interfaces::SGameEvent(CGame::gameevent_health, VAR_HEALTH_DAMAGE_VALUE));
+    }
 
-                g_env->pGame->onEvent(
-                    utils::interfaces::SGameEvent(CGame::gameevent_score, VAR_KILL_SCORE_VALUE));
-            }
-            else if (isSuperAlien(p_item))
-            {
-                delete m_pSuperAlien;
-                m_pSuperAlien = nullptr;
+    void CGameStateInGame::collisionWithRocket(utils::interfaces::IGraphicItem * pRocket,
+                                               utils::interfaces::IGraphicItem * pItem)
+    {
+        // A rocket collides with maximum 1 alien :)) Once deleted, the game area drops its
+        // remaining contacts
+        if (isAlien(pItem))
+        {
+            utils::containers::gFindAndReplace(m_aliens,
+                                               pItem,
+                                               (utils::interfaces::IGraphicItem *)nullptr);
+            delete pItem;
 
-                (*it_rocket) = nullptr;
-                delete p_rocket;
+            g_env->pGame->onEvent(
+                utils::interfaces::SGameEvent(CGame::gameevent_score, VAR_KILL_SCORE_VALUE));
+        }
+        else if (isSuperAlien(pItem))
+        {
+            delete m_pSuperAlien;
+            m_pSuperAlien = nullptr;
 
-                g_env->pGame->onEvent(utils::interfaces::SGameEvent(CGame::gameevent_score,
-                                                                   VAR_KILL_SCORE_SPECIAL_VALUE));
-            }
+            g_env->pGame->onEvent(utils::interfaces::SGameEvent(CGame::gameevent_score,
+                                                               VAR_KILL_SCORE_SPECIAL_VALUE));
+        }
+        else
+        {
+            return;
         }
 
-        utils::containers::gFindAndEraseAll(m_rockets, (utils::interfaces::IGraphicItem *)nullptr);
+        utils::containers::gFindAndErase(m_rockets, pRocket);
+        delete pRocket;
     }
 
     void CGameStateInGame::checkVictoryConditions()
@@ -408,6 +417,8 @@ namespace game {
         }
 
         utils::interfaces::IGraphicBitmap * p_bomb = m_pGameArea->addBitmap(CGame::picture_bomb);
+        p_bomb->setCollisionCategory(CGame::collisioncategory_bomb);
+        p_bomb->setCollisionMask(CGame::collisioncategory_player);
         m_bombs.push_back(p_bomb);
 
         utils::CPoint pos = p_alien->position();
@@ -437,35 +448,29 @@ namespace game {
                                                     0,
                                                     m_pGameArea->size().width(),
                                                     CGame::picture_alien_2.size().height()),
-                                  utils::interfaces::IGraphicItem::collision_mode::intersect)
+                                  utils::interfaces::IGraphicItem::collision_mode::intersect,
+                                  CGame::collisioncategory_alien)
                  .empty())
         {
             return;
         }
 
         m_pSuperAlien = m_pGameArea->addBitmap(CGame::picture_alien_1);
+        m_pSuperAlien->setCollisionCategory(CGame::collisioncategory_alien);
+        m_pSuperAlien->setCollisionMask(CGame::collisioncategory_player |
+                                        CGame::collisioncategory_rocket);
     }
 
     void CGameStateInGame::updateScore()
     {
         assert(m_pScoreTextField);
-        m_pScoreTextField->setText("SCORE: %d", static_cast<CGame *>(g_env->pGame)->score());
+        m_pScoreTextField->setNumber("SCORE: ", static_cast<CGame *>(g_env->pGame)->score());
     }
 
     void CGameStateInGame::updateHealth()
     {
         assert(m_pHealthTextField);
-        m_pHealthTextField->setText("HEALTH: %d", static_cast<CGame *>(g_env->pGame)->lifes());
-    }
-
-    bool CGameStateInGame::isSuperAlien(utils::interfaces::IGraphicItem * pItem) const
-    {
-        return pItem == m_pSuperAlien;
-    }
-
-    bool CGameStateInGame::isPlayer(utils::interfaces::IGraphicItem * pItem) const
-    {
-        return pItem == m_pPlayer;
+        m_pHealthTextField->setNumber("HEALTH: ", static_cast<CGame *>(g_env->pGame)->lifes());
     }
 
     utils::interfaces::IGraphicItem::TGraphicItems CGameStateInGame::aliveAliens() const
@@ -20,20 +20,20 @@
 #pragma once
 #include "GameStateCommon.h"
 #include "GameTimer.h"
+#include <IGraphicBitmap.h>
+#include <IGraphicContainer.h>
 #include <IGraphicItem.h>
 
 namespace utils {
 	namespace interfaces {
 		struct IVariablesManager;
-		struct IGraphicContainer;
-		struct IGraphicBitmap;
 		struct IGraphicTextfield;
 	}
 }
 
 namespace game {
 
-	class CGameStateInGame final : public CGameStateCommon, public utils::IGameTimerListener
+	class CGameStateInGame final : public CGameStateCommon, public utils::IGameTimerListener, public utils::interfaces::IGraphicContactListener
 	{
 	public:
 		CGameStateInGame();
@@ -51,11 +51,16 @@ namespace game {
 		void timeout() override;
 		//~IGameTimerListener
 
+		// IGraphicContactListener
+		void onContactBegin(utils::interfaces::IGraphicItem * pItem, utils::interfaces::IGraphicItem * pOther) override;
+		void onContactEnd(utils::interfaces::IGraphicItem * /*pItem*/, utils::interfaces::IGraphicItem * /*pOther*/) override {}
+		//~IGraphicContactListener
+
 
 	private:
 		void checkCollisionsWithBorder();
-		void checkCollisionsWithPlayer();
-		void checkCollisionsWithRockets();
+		void collisionWithPlayer(utils::interfaces::IGraphicItem * pItem);
+		void collisionWithRocket(utils::interfaces::IGraphicItem * pRocket, utils::interfaces::IGraphicItem * pItem);
 
 		void checkVictoryConditions();
 
@@ -69,11 +74,14 @@ namespace game {
 		void updateScore();
 		void updateHealth();
 
-		inline bool isAlien(utils::interfaces::IGraphicItem * pItem) const { return utils::containers::gFind(m_aliens, pItem); }
-		inline bool isSuperAlien(utils::interfaces::IGraphicItem * pItem) const;
-		inline bool isPlayer(utils::interfaces::IGraphicItem * pItem) const;
-		inline bool isRocket(utils::interfaces::IGraphicItem * pItem) const { return utils::containers::gFind(m_rockets, pItem); }
-		inline bool isBomb(utils::interfaces::IGraphicItem * pItem) const { return utils::containers::gFind(m_bombs, pItem); }
+		/**
+		 * @brief Classifies an alive item using its collision category
+		 */
+		inline bool isAlien(utils::interfaces::IGraphicItem * pItem) const { return pItem->collisionCategory() == CGame::collisioncategory_alien && !isSuperAlien(pItem); }
+		inline bool isSuperAlien(utils::interfaces::IGraphicItem * pItem) const { return pItem == m_pSuperAlien; }
+		inline bool isPlayer(utils::interfaces::IGraphicItem * pItem) const { return pItem == m_pPlayer; }
+		inline bool isRocket(utils::interfaces::IGraphicItem * pItem) const { return pItem->collisionCategory() == CGame::collisioncategory_rocket; }
+		inline bool isBomb(utils::interfaces::IGraphicItem * pItem) const { return pItem->collisionCategory() == CGame::collisioncategory_bomb; }
 
 		/**
 		 * @brief Retreives a list of aliens able to shoot bombs
@@ -111,7 +119,7 @@ namespace game {
 
 		int m_difficulty{ 1 };
 
-		utils::CGameTimer m_timer{ 1 / 60.0f }; // 60 fps
+		utils::CGameTimer m_timer; /* Simulation tick, its rate is given by g_SimulationRateHz */
 
 		utils::interfaces::IVariablesManager * m_pVariables{ nullptr };
 
@@ -53,7 +53,7 @@ namespace game {
 
 	CGameStatePostGame::~CGameStatePostGame()
 	{
-		g_env->pFramework->window()->removeItem(m_pContainer);
+		delete m_pContainer;
 	}
 
 	void CGameStatePostGame::onInput(utils::interfaces::CInputKey get_key, float deltaTime)
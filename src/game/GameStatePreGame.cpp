@@ -59,7 +59,7 @@ namespace game {
 
     CGameStatePreGame::~CGameStatePreGame()
     {
-        g_env->pFramework->window()->removeItem(m_pContainer);
+        delete m_pContainer;
     }
 
     void CGameStatePreGame::onInput(utils::interfaces::CInputKey get_key, float deltaTime)
@@ -24,11 +24,11 @@
 #include "ISystemGlobalEnvironment.h"
 utils::interfaces::SSystemGlobalEnvironment * g_env = nullptr;
 
-#define WIN32_LEAN_AND_MEAN
-#define NOMINMAX
-#include <windows.h>
-
+#if defined(_WIN32)
 static const char * engine_library_name = "Engine.dll";
+#else
+static const char * engine_library_name = "libengine.so";
+#endif
 static const char * engine_library_entry_point_create = "create_engine";
 static const char * engine_library_entry_point_destroy = "destroy_engine";
 
@@ -40,8 +40,8 @@ int main(int argc, char ** argv)
         return -1;
     }
 
-    auto create_engine = (utils::interfaces::IFramework::TEntryFunctionCreate)
-        GetProcAddress(engine_dll.libraryHandler(), engine_library_entry_point_create);
+    auto create_engine = (utils::interfaces::IFramework::TEntryFunctionCreate)engine_dll.symbol(
+        engine_library_entry_point_create);
     if (create_engine == nullptr)
     {
         std::cerr << "[ERROR] Specified " << engine_dll.libraryName() << " doesn't have a valid "
@@ -67,8 +67,8 @@ int main(int argc, char ** argv)
 
     int ret_value = p_framework->exec();
 
-    auto destroy_engine = (utils::interfaces::IFramework::TEntryFunctionDestroy)
-        GetProcAddress(engine_dll.libraryHandler(), engine_library_entry_point_destroy);
+    auto destroy_engine = (utils::interfaces::IFramework::TEntryFunctionDestroy)engine_dll.symbol(
+        engine_library_entry_point_destroy);
     if (destroy_engine == nullptr)
     {
         std::cerr << "[ERROR] Specified " << engine_dll.libraryName() << " doesn't have a valid "
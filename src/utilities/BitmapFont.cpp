@@ -0,0 +1,159 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#include "BitmapFont.h"
+#include <cassert>
+
+namespace utils {
+
+    static const std::uint8_t glyphs[CBitmapFont::glyph_count][CBitmapFont::glyph_height] = {
+        {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // ' '
+        {0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04}, // '!'
+        {0x0A, 0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00}, // '"'
+        {0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A}, // '#'
+        {0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04}, // '$'
+        {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03}, // '%'
+        {0x0C, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0D}, // '&'
+        {0x0C, 0x04, 0x08, 0x00, 0x00, 0x00, 0x00}, // '\''
+        {0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02}, // '('
+        {0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08}, // ')'
+        {0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00}, // '*'
+        {0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00}, // '+'
+        {0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08}, // ','
+        {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00}, // '-'
+        {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C}, // '.'
+        {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00}, // '/'
+        {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}, // '0'
+        {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E}, // '1'
+        {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}, // '2'
+        {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E}, // '3'
+        {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}, // '4'
+        {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E}, // '5'
+        {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}, // '6'
+        {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08}, // '7'
+        {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}, // '8'
+        {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C}, // '9'
+        {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00}, // ':'
+        {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x04, 0x08}, // ';'
+        {0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02}, // '<'
+        {0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00}, // '='
+        {0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08}, // '>'
+        {0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04}, // '?'
+        {0x0E, 0x11, 0x01, 0x0D, 0x15, 0x15, 0x0E}, // '@'
+        {0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}, // 'A'
+        {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E}, // 'B'
+        {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E}, // 'C'
+        {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C}, // 'D'
+        {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F}, // 'E'
+        {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10}, // 'F'
+        {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F}, // 'G'
+        {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}, // 'H'
+        {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E}, // 'I'
+        {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C}, // 'J'
+        {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11}, // 'K'
+        {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F}, // 'L'
+        {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11}, // 'M'
+        {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11}, // 'N'
+        {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, // 'O'
+        {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10}, // 'P'
+        {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D}, // 'Q'
+        {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11}, // 'R'
+        {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E}, // 'S'
+        {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}, // 'T'
+        {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, // 'U'
+        {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04}, // 'V'
+        {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A}, // 'W'
+        {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11}, // 'X'
+        {0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04}, // 'Y'
+        {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F}, // 'Z'
+        {0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E}, // '['
+        {0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00}, // '\\'
+        {0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E}, // ']'
+        {0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00}, // '^'
+        {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F}, // '_'
+        {0x08, 0x04, 0x02, 0x00, 0x00, 0x00, 0x00}, // '`'
+        {0x00, 0x00, 0x0E, 0x01, 0x0F, 0x11, 0x0F}, // 'a'
+        {0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x1E}, // 'b'
+        {0x00, 0x00, 0x0E, 0x10, 0x10, 0x11, 0x0E}, // 'c'
+        {0x01, 0x01, 0x0D, 0x13, 0x11, 0x11, 0x0F}, // 'd'
+        {0x00, 0x00, 0x0E, 0x11, 0x1F, 0x10, 0x0E}, // 'e'
+        {0x06, 0x09, 0x08, 0x1C, 0x08, 0x08, 0x08}, // 'f'
+        {0x00, 0x0F, 0x11, 0x11, 0x0F, 0x01, 0x0E}, // 'g'
+        {0x10, 0x10, 0x16, 0x19, 0x11, 0x11, 0x11}, // 'h'
+        {0x04, 0x00, 0x0C, 0x04, 0x04, 0x04, 0x0E}, // 'i'
+        {0x02, 0x00, 0x06, 0x02, 0x02, 0x12, 0x0C}, // 'j'
+        {0x10, 0x10, 0x12, 0x14, 0x18, 0x14, 0x12}, // 'k'
+        {0x0C, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E}, // 'l'
+        {0x00, 0x00, 0x1A, 0x15, 0x15, 0x11, 0x11}, // 'm'
+        {0x00, 0x00, 0x16, 0x19, 0x11, 0x11, 0x11}, // 'n'
+        {0x00, 0x00, 0x0E, 0x11, 0x11, 0x11, 0x0E}, // 'o'
+        {0x00, 0x00, 0x1E, 0x11, 0x1E, 0x10, 0x10}, // 'p'
+        {0x00, 0x00, 0x0D, 0x13, 0x0F, 0x01, 0x01}, // 'q'
+        {0x00, 0x00, 0x16, 0x19, 0x10, 0x10, 0x10}, // 'r'
+        {0x00, 0x00, 0x0E, 0x10, 0x0E, 0x01, 0x1E}, // 's'
+        {0x08, 0x08, 0x1C, 0x08, 0x08, 0x09, 0x06}, // 't'
+        {0x00, 0x00, 0x11, 0x11, 0x11, 0x13, 0x0D}, // 'u'
+        {0x00, 0x00, 0x11, 0x11, 0x11, 0x0A, 0x04}, // 'v'
+        {0x00, 0x00, 0x11, 0x11, 0x15, 0x15, 0x0A}, // 'w'
+        {0x00, 0x00, 0x11, 0x0A, 0x04, 0x0A, 0x11}, // 'x'
+        {0x00, 0x00, 0x11, 0x11, 0x0F, 0x01, 0x0E}, // 'y'
+        {0x00, 0x00, 0x1F, 0x02, 0x04, 0x08, 0x1F}, // 'z'
+        {0x02, 0x04, 0x04, 0x08, 0x04, 0x04, 0x02}, // '{'
+        {0x04, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}, // '|'
+        {0x08, 0x04, 0x04, 0x02, 0x04, 0x04, 0x08}, // '}'
+        {0x00, 0x00, 0x08, 0x15, 0x02, 0x00, 0x00}, // '~'
+    };
+
+    const std::uint8_t * CBitmapFont::glyph(char c)
+    {
+        if ((c < first_glyph) || (c > last_glyph))
+        {
+            c = '?';
+        }
+
+        return glyphs[c - first_glyph];
+    }
+
+    CSize CBitmapFont::textSize(const char * text)
+    {
+        assert(text);
+
+        int columns = 0;
+        int width = 0;
+        int lines = text[0] != '\0' ? 1 : 0;
+        for (const char * p_char = text; *p_char != '\0'; ++p_char)
+        {
+            if (*p_char == '\n')
+            {
+                columns = 0;
+                ++lines;
+                continue;
+            }
+
+            ++columns;
+            if (columns * advance > width)
+            {
+                width = columns * advance;
+            }
+        }
+
+        return CSize(width, lines * line_height);
+    }
+
+} // namespace utils
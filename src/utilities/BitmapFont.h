@@ -0,0 +1,59 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#pragma once
+#include "Size.h"
+#include <cstdint>
+
+namespace utils {
+
+    /**
+     * @brief CBitmapFont is the fixed 5x7 pixel font of the engine, covering the printable ASCII
+     * characters. Each glyph is stored as 7 rows of 5 bits, the leftmost pixel being bit 4, and
+     * lies in a cell of advance x line_height pixels
+     */
+    class CBitmapFont final
+    {
+      public:
+        static const int glyph_width = 5;
+        static const int glyph_height = 7;
+        static const int advance = 6;
+        static const int line_height = 8;
+
+        /* Characters with a glyph, from first_glyph to last_glyph */
+        static const char first_glyph = ' ';
+        static const char last_glyph = '~';
+        static const int glyph_count = last_glyph - first_glyph + 1;
+
+        CBitmapFont() = delete;
+
+        /**
+         * @brief Returns the glyph_height rows of the glyph of the given character. Characters
+         * without a glyph are drawn as '?'
+         */
+        static const std::uint8_t * glyph(char c);
+
+        /**
+         * @brief Returns the size of the given text, which may span several lines separated by
+         * '\n'
+         */
+        static CSize textSize(const char * text);
+    };
+
+} // namespace utils
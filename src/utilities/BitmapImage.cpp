@@ -0,0 +1,151 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#include "BitmapImage.h"
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace utils {
+
+    static const int bmp_file_header_size = 14;
+    static const int bmp_info_header_size = 40;
+
+    template <typename T>
+    static bool readValue(std::istream & input, std::streamoff offset, T & value)
+    {
+        input.seekg(offset, std::ios::beg);
+        return !!input.read(reinterpret_cast<char *>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    static void writeValue(std::ostream & output, T value)
+    {
+        output.write(reinterpret_cast<const char *>(&value), sizeof(T));
+    }
+
+    CBitmapImage::CBitmapImage(int width, int height, std::uint32_t color)
+        : m_width(width), m_height(height), m_pixels(width * height, color)
+    {
+        assert(width >= 0 && height >= 0);
+    }
+
+    bool CBitmapImage::load(const char * filePath)
+    {
+        assert(filePath && filePath[0]);
+
+        std::ifstream file_input(filePath, std::ios::in | std::ios::binary);
+        if (!file_input.is_open())
+        {
+            return false;
+        }
+
+        char file_format[2] = {'\0'};
+        if (!file_input.read(file_format, sizeof(file_format)) ||
+            (strncmp(file_format, "BM", sizeof(file_format)) != 0))
+        {
+            return false;
+        }
+
+        std::uint32_t data_offset = 0;
+        std::int32_t width = 0;
+        std::int32_t height = 0; // Negative for rows stored from the top to the bottom
+        std::uint16_t bits_per_pixel = 0;
+        std::uint32_t compression = 0;
+        if (!readValue(file_input, 0x0A, data_offset) || !readValue(file_input, 0x12, width) ||
+            !readValue(file_input, 0x16, height) || !readValue(file_input, 0x1C, bits_per_pixel) ||
+            !readValue(file_input, 0x1E, compression))
+        {
+            return false;
+        }
+
+        // Only uncompressed true color images, the ones shipped with the game
+        if ((width <= 0) || (height == 0) || (compression != 0) ||
+            (bits_per_pixel != 24 && bits_per_pixel != 32))
+        {
+            return false;
+        }
+
+        const int rows = std::abs(height);
+        const int bytes_per_pixel = bits_per_pixel / 8;
+        const int stride = ((width * bits_per_pixel + 31) / 32) * 4;
+
+        std::vector<unsigned char> row(stride);
+        std::vector<std::uint32_t> pixels(width * rows);
+
+        file_input.seekg(data_offset, std::ios::beg);
+        for (int i = 0; i < rows; ++i)
+        {
+            if (!file_input.read(reinterpret_cast<char *>(row.data()), stride))
+            {
+                return false;
+            }
+
+            const int y = height > 0 ? rows - 1 - i : i;
+            std::uint32_t * p_line = &pixels[y * width];
+            for (int x = 0; x < width; ++x)
+            {
+                const unsigned char * p_pixel = &row[x * bytes_per_pixel];
+                const std::uint32_t color = p_pixel[0] | (p_pixel[1] << 8) | (p_pixel[2] << 16);
+                p_line[x] = color != 0 ? (color | alpha_mask) : 0;
+            }
+        }
+
+        m_width = width;
+        m_height = rows;
+        m_pixels.swap(pixels);
+        return true;
+    }
+
+    bool CBitmapImage::save(const char * filePath) const
+    {
+        assert(filePath && filePath[0]);
+
+        std::ofstream file_output(filePath, std::ios::out | std::ios::binary);
+        if (!file_output.is_open())
+        {
+            return false;
+        }
+
+        const std::uint32_t data_size = (std::uint32_t)(m_pixels.size() * sizeof(std::uint32_t));
+        const std::uint32_t data_offset = bmp_file_header_size + bmp_info_header_size;
+
+        file_output.write("BM", 2);
+        writeValue<std::uint32_t>(file_output, data_offset + data_size);
+        writeValue<std::uint32_t>(file_output, 0);
+        writeValue<std::uint32_t>(file_output, data_offset);
+
+        writeValue<std::uint32_t>(file_output, bmp_info_header_size);
+        writeValue<std::int32_t>(file_output, m_width);
+        writeValue<std::int32_t>(file_output, -m_height);
+        writeValue<std::uint16_t>(file_output, 1);
+        writeValue<std::uint16_t>(file_output, 32);
+        writeValue<std::uint32_t>(file_output, 0);
+        writeValue<std::uint32_t>(file_output, data_size);
+        writeValue<std::int32_t>(file_output, 2835);
+        writeValue<std::int32_t>(file_output, 2835);
+        writeValue<std::uint32_t>(file_output, 0);
+        writeValue<std::uint32_t>(file_output, 0);
+
+        file_output.write(reinterpret_cast<const char *>(m_pixels.data()), data_size);
+        return !!file_output;
+    }
+
+} // namespace utils
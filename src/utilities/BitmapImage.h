@@ -0,0 +1,63 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace utils {
+
+    /**
+     * @brief CBitmapImage holds the pixels of an image in memory, one 0xAARRGGBB word per pixel
+     * and the rows stored from the top to the bottom. Black is the color key of the game images,
+     * so their black pixels are loaded fully transparent and all the others fully opaque
+     */
+    class CBitmapImage final
+    {
+      public:
+        static const std::uint32_t alpha_mask = 0xFF000000u;
+
+        CBitmapImage() = default;
+        CBitmapImage(int width, int height, std::uint32_t color = 0);
+
+        inline bool isNull() const noexcept { return m_pixels.empty(); }
+        inline int width() const noexcept { return m_width; }
+        inline int height() const noexcept { return m_height; }
+
+        inline const std::uint32_t * scanLine(int y) const { return &m_pixels[y * m_width]; }
+        inline std::uint32_t * scanLine(int y) { return &m_pixels[y * m_width]; }
+
+        /**
+         * @brief Loads an uncompressed 24 or 32 bits per pixel BMP file. Returns false if the file
+         * cannot be read or its format is not supported
+         */
+        bool load(const char * filePath);
+
+        /**
+         * @brief Saves the image as a 32 bits per pixel BMP file. Returns false on failure
+         */
+        bool save(const char * filePath) const;
+
+      private:
+        int m_width{0};
+        int m_height{0};
+        std::vector<std::uint32_t> m_pixels;
+    };
+
+} // namespace utils
@@ -0,0 +1,135 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#include "DrawList.h"
+#include "IPlatform.h"
+#include <cassert>
+#include <cstring>
+
+namespace utils {
+
+    void CDrawList::addSprite(interfaces::ISprite * pSprite,
+                              int x,
+                              int y,
+                              const CRectangle & atlasRectangle)
+    {
+        assert(pSprite);
+
+        SCommand command;
+        command.pSprite = pSprite;
+        command.x = x;
+        command.y = y;
+        if (atlasRectangle.isValid())
+        {
+            command.atlasX = (std::uint16_t)atlasRectangle.x();
+            command.atlasY = (std::uint16_t)atlasRectangle.y();
+            command.atlasWidth = (std::uint16_t)atlasRectangle.width();
+            command.atlasHeight = (std::uint16_t)atlasRectangle.height();
+        }
+
+        m_commands.push_back(command);
+    }
+
+    void CDrawList::addText(int x, int y, const char * text)
+    {
+        assert(text);
+
+        SCommand command;
+        command.type = command_type::text;
+        command.x = x;
+        command.y = y;
+        command.text = (std::uint32_t)m_texts.size();
+        m_commands.push_back(command);
+
+        m_texts.insert(m_texts.end(), text, text + strlen(text) + 1);
+    }
+
+    void CDrawList::addGlyph(int x, int y, char character, const CRectangle & atlasRectangle)
+    {
+        assert(atlasRectangle.isValid());
+
+        SCommand command;
+        command.type = command_type::glyph;
+        command.character = character;
+        command.x = x;
+        command.y = y;
+        command.atlasX = (std::uint16_t)atlasRectangle.x();
+        command.atlasY = (std::uint16_t)atlasRectangle.y();
+        command.atlasWidth = (std::uint16_t)atlasRectangle.width();
+        command.atlasHeight = (std::uint16_t)atlasRectangle.height();
+        m_commands.push_back(command);
+    }
+
+    void CDrawList::addDamage(const CRectangle & rectangle)
+    {
+        if (rectangle.isEmpty())
+        {
+            return;
+        }
+
+        if (m_damage.size() < max_damage)
+        {
+            m_damage.push_back(rectangle);
+            return;
+        }
+
+        CRectangle bounds = rectangle;
+        for (const CRectangle & damage : m_damage)
+        {
+            bounds = bounds.united(damage);
+        }
+
+        m_damage.assign(1, bounds);
+    }
+
+    void CDrawList::clear()
+    {
+        m_commands.clear();
+        m_texts.clear();
+        m_damage.clear();
+        m_fullRedraw = false;
+    }
+
+    void CDrawList::replay(interfaces::IPlatform * pPlatform) const
+    {
+        assert(pPlatform);
+
+        for (const SCommand & command : m_commands)
+        {
+            switch (command.type)
+            {
+                case command_type::sprite:
+                    command.pSprite->draw(command.x, command.y);
+                    break;
+
+                case command_type::text:
+                    pPlatform->drawText(command.x, command.y, text(command));
+                    break;
+
+                case command_type::glyph:
+                {
+                    const char glyph_text[2] = {command.character, '\0'};
+                    pPlatform->drawText(command.x, command.y, glyph_text);
+                    break;
+                }
+            }
+        }
+    }
+
+} // namespace utils
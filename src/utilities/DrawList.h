@@ -0,0 +1,126 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#pragma once
+#include "Rectangle.h"
+#include <cstdint>
+#include <vector>
+
+namespace utils {
+
+    namespace interfaces {
+        struct IPlatform;
+        struct ISprite;
+    }
+
+    /**
+     * @brief CDrawList records the sprites and the texts drawn during a frame, in order, so they
+     * can be handed to the platform at once. The texts are copied in a single buffer owned by the
+     * list, the sprites are referenced and must outlive the frame. A text may also be recorded as
+     * its glyphs, each one a character of CBitmapFont copied from the texture atlas like a sprite.
+     * Next to the commands, the list carries the damage of the frame: the regions of the window
+     * whose content changed since the previous list. A platform able to update only part of its
+     * window may redraw just those regions, with the commands overlapping them
+     */
+    class CDrawList final
+    {
+      public:
+        enum class command_type : std::uint8_t
+        {
+            sprite,
+            text,
+            glyph
+        };
+
+        struct SCommand
+        {
+            interfaces::ISprite * pSprite{nullptr}; /* nullptr for a text and a glyph */
+            int x{0};
+            int y{0};
+            std::uint32_t text{0}; /* Offset of the text in the list */
+
+            /* Rectangle of the sprite image or of the glyph in the texture atlas, empty when the
+             * sprite is not packed */
+            std::uint16_t atlasX{0};
+            std::uint16_t atlasY{0};
+            std::uint16_t atlasWidth{0};
+            std::uint16_t atlasHeight{0};
+
+            command_type type{command_type::sprite};
+            char character{'\0'}; /* Character of a glyph */
+        };
+
+        typedef std::vector<SCommand> TCommands;
+
+        static const size_t max_damage = 256;
+
+      public:
+        CDrawList() = default;
+
+        inline bool isEmpty() const noexcept { return m_commands.empty(); }
+        inline const TCommands & commands() const noexcept { return m_commands; }
+        inline const char * text(const SCommand & command) const { return &m_texts[command.text]; }
+
+        /**
+         * @brief Damaged regions, in window coordinates. Meaningless when isFullRedraw()
+         */
+        inline const std::vector<CRectangle> & damage() const noexcept { return m_damage; }
+
+        /**
+         * @brief True when the whole window must be redrawn, whatever the damage
+         */
+        inline bool isFullRedraw() const noexcept { return m_fullRedraw; }
+        inline void setFullRedraw(bool fullRedraw) noexcept { m_fullRedraw = fullRedraw; }
+
+        void addSprite(interfaces::ISprite * pSprite,
+                       int x,
+                       int y,
+                       const CRectangle & atlasRectangle = CRectangle());
+        void addText(int x, int y, const char * text);
+
+        /**
+         * @brief Adds a single character of CBitmapFont, whose glyph lies at atlasRectangle in the
+         * texture atlas handed to the platform
+         */
+        void addGlyph(int x, int y, char character, const CRectangle & atlasRectangle);
+
+        /**
+         * @brief Adds a damaged region. Empty rectangles are ignored, and past max_damage
+         * rectangles the damage collapses into their bounding rectangle
+         */
+        void addDamage(const CRectangle & rectangle);
+
+        /**
+         * @brief Removes all the commands and the damage. The memory is kept for the next frame
+         */
+        void clear();
+
+        /**
+         * @brief Draws the commands on a platform without a batch entry point, one call each
+         */
+        void replay(interfaces::IPlatform * pPlatform) const;
+
+      private:
+        TCommands m_commands;
+        std::vector<char> m_texts;
+        std::vector<CRectangle> m_damage;
+        bool m_fullRedraw{false};
+    };
+
+} // namespace utils
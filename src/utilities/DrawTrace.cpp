@@ -0,0 +1,253 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#include "DrawTrace.h"
+#include "BitmapFont.h"
+#include "DrawList.h"
+#include <cassert>
+#include <cstring>
+
+namespace utils {
+
+    static const char trace_tag[4] = {'L', 'I', 'D', 'T'};
+    static const std::uint32_t trace_version = 2; /* 2 added the glyphs */
+
+    bool CDrawTraceWriter::open(const char * filePath, int width, int height)
+    {
+        assert(filePath && filePath[0]);
+
+        close();
+
+        m_file.open(filePath, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!m_file.is_open())
+        {
+            return false;
+        }
+
+        m_spriteIds.clear();
+        m_nextSpriteId = 0;
+        m_frames = 0;
+        m_bytes = 0;
+
+        m_buffer.assign(trace_tag, trace_tag + sizeof(trace_tag));
+        put<std::uint32_t>(trace_version);
+        put<std::uint32_t>((std::uint32_t)width);
+        put<std::uint32_t>((std::uint32_t)height);
+        flush();
+
+        return !!m_file;
+    }
+
+    void CDrawTraceWriter::close()
+    {
+        if (!m_file.is_open())
+        {
+            return;
+        }
+
+        flush();
+        m_file.close();
+    }
+
+    void CDrawTraceWriter::defineSprite(const interfaces::ISprite * pSprite, const char * imagePath)
+    {
+        assert(pSprite && imagePath);
+
+        const std::uint16_t id = m_nextSpriteId++;
+        m_spriteIds[pSprite] = id;
+
+        put<char>((char)CDrawTraceReader::record_type::sprite);
+        put<std::uint16_t>(id);
+        put(imagePath, strlen(imagePath));
+    }
+
+    void CDrawTraceWriter::writeFrame(const CDrawList & drawList)
+    {
+        for (const CDrawList::SCommand & command : drawList.commands())
+        {
+            switch (command.type)
+            {
+                case CDrawList::command_type::sprite:
+                {
+                    auto it = m_spriteIds.find(command.pSprite);
+                    assert(it != m_spriteIds.end());
+
+                    put<char>((char)CDrawTraceReader::record_type::draw);
+                    put<std::uint16_t>(it->second);
+                    put<std::int16_t>((std::int16_t)command.x);
+                    put<std::int16_t>((std::int16_t)command.y);
+                    break;
+                }
+
+                case CDrawList::command_type::text:
+                {
+                    const char * text = drawList.text(command);
+
+                    put<char>((char)CDrawTraceReader::record_type::text);
+                    put<std::int16_t>((std::int16_t)command.x);
+                    put<std::int16_t>((std::int16_t)command.y);
+                    put(text, strlen(text));
+                    break;
+                }
+
+                case CDrawList::command_type::glyph:
+                    put<char>((char)CDrawTraceReader::record_type::glyph);
+                    put<std::int16_t>((std::int16_t)command.x);
+                    put<std::int16_t>((std::int16_t)command.y);
+                    put<char>(command.character);
+                    break;
+            }
+        }
+
+        put<char>((char)CDrawTraceReader::record_type::frame);
+        flush();
+        ++m_frames;
+    }
+
+    template <typename T> void CDrawTraceWriter::put(T value)
+    {
+        const char * p_bytes = reinterpret_cast<const char *>(&value);
+        m_buffer.insert(m_buffer.end(), p_bytes, p_bytes + sizeof(T));
+    }
+
+    void CDrawTraceWriter::put(const char * text, size_t length)
+    {
+        assert(length <= 0xFFFF);
+        put<std::uint16_t>((std::uint16_t)length);
+        m_buffer.insert(m_buffer.end(), text, text + length);
+    }
+
+    void CDrawTraceWriter::flush()
+    {
+        m_file.write(m_buffer.data(), m_buffer.size());
+        m_bytes += m_buffer.size();
+        m_buffer.clear();
+    }
+
+    bool CDrawTraceReader::open(const char * filePath)
+    {
+        assert(filePath && filePath[0]);
+
+        m_file.close();
+        m_file.open(filePath, std::ios::in | std::ios::binary);
+        if (!m_file.is_open())
+        {
+            return false;
+        }
+
+        char tag[sizeof(trace_tag)] = {'\0'};
+        std::uint32_t version = 0;
+        std::uint32_t width = 0;
+        std::uint32_t height = 0;
+        if (!m_file.read(tag, sizeof(tag)) || (memcmp(tag, trace_tag, sizeof(tag)) != 0) ||
+            !get(version) || (version == 0) || (version > trace_version) || !get(width) || !get(height))
+        {
+            m_file.close();
+            return false;
+        }
+
+        m_width = (int)width;
+        m_height = (int)height;
+        return true;
+    }
+
+    bool CDrawTraceReader::read(SRecord & record)
+    {
+        char type = 0;
+        if (!get(type))
+        {
+            return false;
+        }
+
+        record.type = (record_type)type;
+        switch (record.type)
+        {
+            case record_type::sprite:
+                return get(record.sprite) && get(record.text);
+
+            case record_type::draw:
+            {
+                std::int16_t x = 0;
+                std::int16_t y = 0;
+                if (!get(record.sprite) || !get(x) || !get(y))
+                {
+                    return false;
+                }
+
+                record.x = x;
+                record.y = y;
+                return true;
+            }
+
+            case record_type::text:
+            {
+                std::int16_t x = 0;
+                std::int16_t y = 0;
+                if (!get(x) || !get(y) || !get(record.text))
+                {
+                    return false;
+                }
+
+                record.x = x;
+                record.y = y;
+                return true;
+            }
+
+            case record_type::glyph:
+            {
+                std::int16_t x = 0;
+                std::int16_t y = 0;
+                char character = '\0';
+                if (!get(x) || !get(y) || !get(character) ||
+                    (character < CBitmapFont::first_glyph) || (character > CBitmapFont::last_glyph))
+                {
+                    return false;
+                }
+
+                record.x = x;
+                record.y = y;
+                record.text.assign(1, character);
+                return true;
+            }
+
+            case record_type::frame:
+                return true;
+        }
+
+        return false;
+    }
+
+    template <typename T> bool CDrawTraceReader::get(T & value)
+    {
+        return !!m_file.read(reinterpret_cast<char *>(&value), sizeof(T));
+    }
+
+    bool CDrawTraceReader::get(std::string & text)
+    {
+        std::uint16_t length = 0;
+        if (!get(length))
+        {
+            return false;
+        }
+
+        text.resize(length);
+        return (length == 0) || !!m_file.read(&text[0], length);
+    }
+
+} // namespace utils
@@ -0,0 +1,142 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace utils {
+
+    class CDrawList;
+
+    namespace interfaces {
+        struct ISprite;
+    }
+
+    /**
+     * @brief A draw trace records the draw lists of a session, so the frames can be drawn again
+     * without the game. The file starts with the "LIDT" tag, the format version and the size of
+     * the window as two uint32, followed by records starting with their type, one byte:
+     * - 'S' sprite: uint16 id, uint16 length and characters of the image path. Written once per
+     *   sprite, before its first draw
+     * - 'D' draw: uint16 id of the sprite, int16 x, int16 y
+     * - 'T' text: int16 x, int16 y, uint16 length and characters of the text
+     * - 'G' glyph: int16 x, int16 y, the character
+     * - 'F' frame: end of the draws of a frame
+     * The values are stored in the byte order of the machine recording the trace
+     */
+    class CDrawTraceWriter final
+    {
+      public:
+        CDrawTraceWriter() = default;
+        CDrawTraceWriter(const CDrawTraceWriter &) = delete;
+        CDrawTraceWriter & operator=(const CDrawTraceWriter &) = delete;
+
+        /**
+         * @brief Creates the trace file. Returns false if it cannot be written
+         */
+        bool open(const char * filePath, int width, int height);
+        void close();
+
+        inline bool isOpen() const { return m_file.is_open(); }
+        inline unsigned int frames() const noexcept { return m_frames; }
+        inline unsigned long long bytes() const noexcept { return m_bytes; }
+
+        /**
+         * @brief Gives an id to a sprite created from the given image. A sprite must be defined
+         * before it is drawn, and defined again if its address is reused by another sprite
+         */
+        void defineSprite(const interfaces::ISprite * pSprite, const char * imagePath);
+
+        /**
+         * @brief Appends the commands of the list as a frame
+         */
+        void writeFrame(const CDrawList & drawList);
+
+      private:
+        template <typename T> void put(T value);
+        void put(const char * text, size_t length);
+        void flush();
+
+      private:
+        std::ofstream m_file;
+        std::vector<char> m_buffer; /* Records not written yet, flushed once per frame */
+        std::unordered_map<const interfaces::ISprite *, std::uint16_t> m_spriteIds;
+        std::uint16_t m_nextSpriteId{0};
+        unsigned int m_frames{0};
+        unsigned long long m_bytes{0};
+    };
+
+    /**
+     * @brief Reads the records of a draw trace, see CDrawTraceWriter
+     */
+    class CDrawTraceReader final
+    {
+      public:
+        enum class record_type : char
+        {
+            sprite = 'S',
+            draw = 'D',
+            text = 'T',
+            glyph = 'G',
+            frame = 'F'
+        };
+
+        struct SRecord
+        {
+            record_type type{record_type::frame};
+            std::uint16_t sprite{0};
+            int x{0};
+            int y{0};
+            std::string text; /* Image path of a sprite, characters of a text or of a glyph */
+        };
+
+      public:
+        CDrawTraceReader() = default;
+        CDrawTraceReader(const CDrawTraceReader &) = delete;
+        CDrawTraceReader & operator=(const CDrawTraceReader &) = delete;
+
+        /**
+         * @brief Opens a trace file. Returns false if it cannot be read or is not a trace
+         */
+        bool open(const char * filePath);
+
+        inline int width() const noexcept { return m_width; }
+        inline int height() const noexcept { return m_height; }
+
+        /**
+         * @brief Reads the next record. Returns false at the end of the trace, or on a damaged
+         * record
+         */
+        bool read(SRecord & record);
+
+      private:
+        template <typename T> bool get(T & value);
+        bool get(std::string & text);
+
+      private:
+        std::ifstream m_file;
+        int m_width{0};
+        int m_height{0};
+    };
+
+} // namespace utils
@@ -24,6 +24,9 @@
 #include "Size.h"
 
 namespace utils {
+
+	class CPicture;
+
 	namespace interfaces {
 
 		struct IGraphicContainer;
@@ -51,6 +54,12 @@ namespace utils {
 			 */
 			virtual int exec() = 0;
 
+			/**
+			 * @brief Draws the frames of a draw trace recorded through the sys_drawTrace variable, as fast as the
+			 * platform allows, instead of running the game. Used to benchmark the platforms
+			 */
+			virtual int replay(const char * tracePath) = 0;
+
 			/**
 			 * @brief Retrieves the total elaptsed time since the start up
 			 */
@@ -75,6 +84,13 @@ namespace utils {
 			 * @brief Retreives the variables manager
 			 */
 			virtual IVariablesManager * variablesManager() const = 0;
+
+			/**
+			 * @brief Packs the images of the given pictures in a single texture atlas, handed to the platform, and sets
+			 * the rectangle of each picture in it. Pictures sharing an image share its rectangle
+			 * @return false if an image cannot be read or packed
+			 */
+			virtual bool packPictures(CPicture * const pPictures[], size_t count) = 0;
 		};
 
 	} // namespace interfaces
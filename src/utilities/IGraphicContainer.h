@@ -18,6 +18,7 @@
 ****************************************************************************************/
 
 #pragma once
+#include "BaseListenerHandler.h"
 #include "IGraphicItem.h"
 #include "Picture.h"
 
@@ -27,13 +28,53 @@ namespace utils {
 		struct IGraphicBitmap;
 		struct IGraphicTextfield;
 
-		struct IGraphicContainer : public virtual IGraphicItem
+		struct IGraphicContactListener
 		{
+			/**
+			 * @brief Two children of the container started colliding. The mask of pItem matches the category of pOther;
+			 * when both masks match, the pair is reported once and its order is unspecified
+			 */
+			virtual void onContactBegin(IGraphicItem * pItem, IGraphicItem * pOther) = 0;
+
+			/**
+			 * @brief Two children of the container stopped colliding. It is not reported when one of them is removed
+			 */
+			virtual void onContactEnd(IGraphicItem * pItem, IGraphicItem * pOther) = 0;
+		};
+
+		/**
+		 * @brief Containers with at least one contact listener track the contacts between their children once per frame
+		 * and notify only the contacts which started or ended since the previous frame. Contacts are tested with
+		 * collision_mode::swept_intersect, so fast children cannot pass through each other unnoticed
+		 */
+		struct IGraphicContainer : public virtual IGraphicItem, public CBaseListenerHandler<IGraphicContactListener>
+		{
+			enum class broadphase_mode
+			{
+				brute_force = 0, /* Collision queries test every child of the container */
+				uniform_grid, /* Children are indexed in a uniform grid, whose cell size is given by the sys_gridCellSize variable */
+				sweep_and_prune /* Children are kept sorted along the x axis and re-sorted incrementally, suited to items keeping their order while moving */
+			};
+
 			virtual IGraphicContainer * addContainer() = 0;
 			virtual IGraphicBitmap * addBitmap(const CPicture & picture) = 0;
 			virtual IGraphicTextfield * addTextfield(const char * text = nullptr) = 0;
 
 			virtual void removeItem(IGraphicItem * pItem) = 0;
+
+			/**
+			 * @brief Selects the strategy used to find the children colliding with a query
+			 */
+			virtual void setBroadphase(broadphase_mode mode) = 0;
+			virtual broadphase_mode broadphase() const = 0;
+
+			/**
+			 * @brief Finds in one pass every pair made of an item of items and an item of others whose shapes collide,
+			 * provided the mask of the first item matches the category of the second one.
+			 * The pairs are written in the given buffer, which is cleared first so its capacity can be reused across calls.
+			 * nullptr entries in the input sets are skipped
+			 */
+			virtual void collidingPairs(const TGraphicItems & items, const TGraphicItems & others, TGraphicItemsPairs & pairs, collision_mode mode = collision_mode::intersect) const = 0;
 		};
 
 	} // namespace interfaces
@@ -19,14 +19,23 @@
 
 #pragma once
 #include "Rectangle.h"
+#include <utility>
 #include <vector>
 
 namespace utils {
+
+    class COpacityMask;
+
     namespace interfaces {
 
         struct IGraphicItem
         {
             typedef std::vector<IGraphicItem *> TGraphicItems;
+            typedef std::pair<IGraphicItem *, IGraphicItem *> TGraphicItemsPair;
+            typedef std::vector<TGraphicItemsPair> TGraphicItemsPairs;
+
+            static const unsigned int collision_category_default = 0x1;
+            static const unsigned int collision_mask_all = 0xffffffff;
 
             enum class collision_mode
             {
@@ -35,13 +44,21 @@ namespace utils {
                 intersect_not_contain, /* The output list contains only items whose shapes interesct
                                           with the one of the current item, but is not fully
                                           contained */
-                intersect /* The output list contains only items whose shapes are intersecting at
-                             least by 1 pixel with the one of the current item */
+                intersect, /* The output list contains only items whose shapes are intersecting at
+                              least by 1 pixel with the one of the current item */
+                swept_intersect /* As intersect, but the shapes are swept along the path the items
+                                   moved since the beginning of the frame, so fast items cannot
+                                   pass through each other between two frames */
             };
 
             virtual IGraphicItem * parent() const = 0;
 
             virtual CPoint position() const = 0;
+
+            /**
+             * @brief Retrieves the position the item had at the beginning of the current frame
+             */
+            virtual CPoint previousPosition() const = 0;
             virtual void setPosition(const CPoint & position) = 0;
             virtual void setPosition(double x, double y) = 0;
 
@@ -56,6 +73,43 @@ namespace utils {
             virtual const TGraphicItems & items() const = 0;
             virtual CRectangle shape() const = 0;
 
+            /**
+             * @brief The children of an item are painted by increasing layer, then by increasing z
+             * value, then in the order they were added to the item. Each child is painted with
+             * all its descendants, so the order only applies among siblings
+             */
+            virtual int layer() const = 0;
+            virtual void setLayer(int layer) = 0;
+            virtual double zValue() const = 0;
+            virtual void setZValue(double z) = 0;
+
+            /**
+             * @brief Retrieves the position of the item in window coordinates
+             */
+            virtual CPoint scenePosition() const = 0;
+
+            /**
+             * @brief Retrieves the shape of the item in window coordinates
+             */
+            virtual CRectangle sceneShape() const = 0;
+
+            /**
+             * @brief Each item belongs to the collision categories whose bits are set in its
+             * category, and only reports collisions with the items whose category matches its
+             * mask. Queries discard the items filtered out by the bits before any shape test
+             */
+            virtual unsigned int collisionCategory() const = 0;
+            virtual void setCollisionCategory(unsigned int category) = 0;
+            virtual unsigned int collisionMask() const = 0;
+            virtual void setCollisionMask(unsigned int mask) = 0;
+
+            /**
+             * @brief Retrieves the opaque pixels of the item, relative to its position, or nullptr
+             * when the whole shape is solid. When both items have a mask, collisions in intersect
+             * modes also require an opaque pixel of each item to overlap
+             */
+            virtual const COpacityMask * opacityMask() const = 0;
+
             virtual bool collidesWithItem(
                 const IGraphicItem * pOther,
                 collision_mode mode = collision_mode::intersect) const = 0;
@@ -67,7 +121,8 @@ namespace utils {
                 collision_mode mode = collision_mode::intersect) const = 0;
             virtual TGraphicItems collidingItems(
                 const CRectangle & rectangle,
-                collision_mode mode = collision_mode::intersect) const = 0;
+                collision_mode mode = collision_mode::intersect,
+                unsigned int mask = collision_mask_all) const = 0;
 
             virtual ~IGraphicItem(){};
         };
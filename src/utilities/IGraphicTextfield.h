@@ -27,6 +27,12 @@ namespace utils {
 		{
 			virtual const char * text() = 0;
 			virtual void setText(const char * format, ...) = 0;
+
+			/**
+			 * @brief Sets the text to prefix followed by value in decimal, without going through the format
+			 * parsing. Setting the text it already shows damages nothing
+			 */
+			virtual void setNumber(const char * prefix, int value) = 0;
 		};
 
 	} // namespace interfaces
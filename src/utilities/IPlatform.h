@@ -19,6 +19,10 @@
 
 #pragma once
 
+#if !defined(_WIN32) && !defined(__cdecl)
+#define __cdecl
+#endif
+
 namespace utils {
 	namespace interfaces {
 
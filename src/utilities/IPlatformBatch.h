@@ -0,0 +1,56 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#pragma once
+
+namespace utils {
+
+	class CBitmapImage;
+	class CDrawList;
+
+	namespace interfaces {
+
+		/**
+		 * @brief Optional entry point of a platform drawing a whole frame in one call, instead of
+		 * one call per sprite and per text. Retrieved through IPlatformManager::batch()
+		 * The framework may call submit from a render thread, concurrently with the calls of the main
+		 * thread to the other methods of the platform, apart from init and destroy
+		 */
+		struct IPlatformBatch
+		{
+			/**
+			 * @brief Draws all the commands of the list, in order. Equivalent to calling
+			 * ISprite::draw and IPlatform::drawText for each of them, a glyph being a text of a single
+			 * character copied from the atlas. A platform keeping the previous frame
+			 * may redraw only the damage of the list, unless it asks for a full redraw. The texts are damaged
+			 * with the metrics of CBitmapFont
+			 */
+			virtual void submit(const CDrawList & drawList) = 0;
+
+			/**
+			 * @brief Hands the texture atlas the sprite and glyph commands of the draw lists may refer to. Returns false
+			 * if the platform keeps drawing the sprites from their own images and the glyphs as texts
+			 */
+			virtual bool setAtlas(const CBitmapImage & atlas) = 0;
+
+			virtual ~IPlatformBatch() {};
+		};
+
+	} // namespace interfaces
+} // namespace utils
@@ -23,10 +23,18 @@ namespace utils {
 	namespace interfaces {
 
 		struct IPlatform;
+		struct IPlatformBatch;
 
 		struct IPlatformManager
 		{
 			virtual IPlatform * platform() const = 0;
+
+			/**
+			 * @brief Retrieves the batch entry point of the platform, nullptr if the platform only
+			 * draws one sprite or text per call
+			 */
+			virtual IPlatformBatch * batch() const { return nullptr; }
+
 			virtual ~IPlatformManager() {};
 		};
 
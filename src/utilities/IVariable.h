@@ -18,47 +18,100 @@
 ****************************************************************************************/
 
 #pragma once
+#include <cstdlib>
+#include <cstring>
 #include <string>
 
 namespace utils {
 	namespace interfaces {
 
+		template <class T>
+		class CVariable;
+
+		/**
+		 * @brief Type of the value of a variable. Each variable is tagged with its type, so its value
+		 * is retrieved with a comparison of the tags instead of a dynamic_cast
+		 */
+		enum class variable_type
+		{
+			boolean,
+			unsigned_integer,
+			integer,
+			single_precision,
+			double_precision,
+			string
+		};
+
+		/**
+		 * @brief Tag of each type a variable can hold
+		 */
+		template <typename T>
+		struct SVariableType;
+
+		template <> struct SVariableType<bool>
+		{
+			static const variable_type value = variable_type::boolean;
+		};
+		template <> struct SVariableType<unsigned int>
+		{
+			static const variable_type value = variable_type::unsigned_integer;
+		};
+		template <> struct SVariableType<int>
+		{
+			static const variable_type value = variable_type::integer;
+		};
+		template <> struct SVariableType<float>
+		{
+			static const variable_type value = variable_type::single_precision;
+		};
+		template <> struct SVariableType<double>
+		{
+			static const variable_type value = variable_type::double_precision;
+		};
+		template <> struct SVariableType<std::string>
+		{
+			static const variable_type value = variable_type::string;
+		};
+
 		struct IVariable
 		{
+			explicit IVariable(variable_type type) : m_type(type) {}
+
+			inline variable_type type() const { return m_type; }
+
 			template<typename T>
-			T setValue(T value, bool * ok = nullptr) const
+			void setValue(T value, bool * ok = nullptr)
 			{
 				if (ok) *ok = false;
-
-				CVariable<T> * pCVar = dynamic_cast<CVariable<T> *>(this);
-				if (!pCVar) return;
+				if (m_type != SVariableType<T>::value) return;
 
 				if (ok) *ok = true;
-				pCVar->setValueInternal(value);
+				static_cast<CVariable<T> *>(this)->setValueInternal(value);
 			}
 
 			template<typename T>
 			T value(bool * ok = nullptr) const
 			{
 				if (ok) *ok = false;
-
-				const CVariable<T> * pCVar = dynamic_cast<const CVariable<T> *>(this);
-				if (!pCVar) return T();
+				if (m_type != SVariableType<T>::value) return T();
 
 				if (ok) *ok = true;
-				return pCVar->valueInternal();
+				return static_cast<const CVariable<T> *>(this)->valueInternal();
 			}
 
 			virtual ~IVariable() {}
+
+		private:
+			const variable_type m_type;
 		};
 
 		template <class T>
 		class CVariable : public IVariable
 		{
 		public:
-			CVariable() = default;
+			CVariable() : IVariable(SVariableType<T>::value) {}
 			inline CVariable(const char * value);
-			CVariable(T value) :m_value(value) {}
+			CVariable(T value) : IVariable(SVariableType<T>::value), m_value(value) {}
 
 			inline void setValueInternal(T value) { m_value = value; }
 			inline T valueInternal() const { return m_value; }
@@ -69,36 +122,42 @@ namespace utils {
 
 		template<>
 		inline CVariable<bool>::CVariable(const char * value)
+			: IVariable(variable_type::boolean)
 		{
 			m_value = strcmp(value, "false") == 0 ? false : true;
 		}
 
 		template<>
 		inline CVariable<unsigned int>::CVariable(const char * value)
+			: IVariable(variable_type::unsigned_integer)
 		{
 			m_value = (unsigned int)std::strtoul(value, nullptr, 0);
 		}
 
 		template<>
 		inline CVariable<int>::CVariable(const char * value)
+			: IVariable(variable_type::integer)
 		{
 			m_value = atoi(value);
 		}
 
 		template<>
 		inline CVariable<float>::CVariable(const char * value)
+			: IVariable(variable_type::single_precision)
 		{
 			m_value = (float)atof(value);
 		}
 
 		template<>
 		inline CVariable<double>::CVariable(const char * value)
+			: IVariable(variable_type::double_precision)
 		{
 			m_value = atof(value);
 		}
 
 		template<>
 		inline CVariable<std::string>::CVariable(const char * value)
+			: IVariable(variable_type::string)
 		{
 			m_value = value;
 		}
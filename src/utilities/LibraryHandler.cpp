@@ -18,12 +18,17 @@
 ****************************************************************************************/
 
 #include "LibraryHandler.h"
+#include "Path.h"
 #include <cassert>
 #include <iostream>
 
+#if defined(_WIN32)
 #define WIN32_LEAN_AND_MEAN
 #define NOMINMAX 
 #include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
 
 namespace utils {
 
@@ -38,7 +43,11 @@ namespace utils {
 	{
 		if (m_libraryHandler != nullptr)
 		{
-			FreeLibrary(m_libraryHandler);
+#if defined(_WIN32)
+			FreeLibrary((HMODULE)m_libraryHandler);
+#else
+			dlclose(m_libraryHandler);
+#endif
 		}
 	}
 
@@ -50,7 +59,21 @@ namespace utils {
 			return false;
 		}
 
+#if defined(_WIN32)
 		m_libraryHandler = LoadLibraryA(m_libraryName.c_str());
+#else
+		// Unlike LoadLibrary, dlopen doesn't look next to the executable
+		if (m_libraryName.find('/') == std::string::npos)
+		{
+			std::string local_path = path_utils::executablePath() + "/" + m_libraryName;
+			m_libraryHandler = dlopen(local_path.c_str(), RTLD_NOW);
+		}
+
+		if (m_libraryHandler == nullptr)
+		{
+			m_libraryHandler = dlopen(m_libraryName.c_str(), RTLD_NOW);
+		}
+#endif
 		if (m_libraryHandler == nullptr)
 		{
 			std::cerr << "[ERROR] Failed to open the DLL " << m_libraryName.c_str() << std::endl;
@@ -60,11 +83,27 @@ namespace utils {
 		return true;
 	}
 
-	HMODULE CLibraryHandler::libraryHandler() const
+	CLibraryHandler::THandle CLibraryHandler::libraryHandler() const
 	{
 		return m_libraryHandler;
 	}
 
+	void * CLibraryHandler::symbol(const char * name) const
+	{
+		assert(name && name[0]);
+
+		if (m_libraryHandler == nullptr)
+		{
+			return nullptr;
+		}
+
+#if defined(_WIN32)
+		return (void *)GetProcAddress((HMODULE)m_libraryHandler, name);
+#else
+		return dlsym(m_libraryHandler, name);
+#endif
+	}
+
 	const char * CLibraryHandler::libraryName() const
 	{
 		return m_libraryName.c_str();
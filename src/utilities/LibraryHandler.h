@@ -20,9 +20,14 @@
 #pragma once
 #include <string>
 
-class HINSTANCE__;
-typedef HINSTANCE__* HINSTANCE;
-typedef HINSTANCE HMODULE;
+/**
+ * @brief Marks the entry points a library exports to its CLibraryHandler
+ */
+#if defined(_WIN32)
+#define LIBRARY_EXPORT __declspec(dllexport)
+#else
+#define LIBRARY_EXPORT __attribute__((visibility("default")))
+#endif
 
 namespace utils {
 
@@ -36,12 +41,19 @@ namespace utils {
 
 		virtual bool init();
 
-		HMODULE libraryHandler() const;
+		typedef void * THandle;
+
+		THandle libraryHandler() const;
 		const char * libraryName() const;
 
+		/**
+		 * @brief Returns the address of the given exported symbol, nullptr if it is missing
+		 */
+		void * symbol(const char * name) const;
+
 	private:
 		std::string m_libraryName;
-		HMODULE m_libraryHandler;
+		THandle m_libraryHandler;
 	};
 
 } // namespace utils
@@ -0,0 +1,99 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#include "OpacityMask.h"
+#include <algorithm>
+#include <cassert>
+
+namespace utils {
+
+    static const int bits_per_word = 64;
+
+    COpacityMask::COpacityMask(int width, int height)
+        : m_width(width)
+        , m_height(height)
+        , m_wordsPerRow((width + bits_per_word - 1) / bits_per_word)
+        , m_words(m_wordsPerRow * height, 0)
+    {
+        assert(width >= 0 && height >= 0);
+    }
+
+    bool COpacityMask::testBit(int x, int y) const
+    {
+        if (x < 0 || y < 0 || x >= m_width || y >= m_height)
+        {
+            return false;
+        }
+
+        const std::uint64_t word = m_words[y * m_wordsPerRow + x / bits_per_word];
+        return ((word >> (x % bits_per_word)) & 1) != 0;
+    }
+
+    void COpacityMask::setBit(int x, int y, bool opaque)
+    {
+        assert(x >= 0 && y >= 0 && x < m_width && y < m_height);
+
+        std::uint64_t & word = m_words[y * m_wordsPerRow + x / bits_per_word];
+        const std::uint64_t bit = std::uint64_t(1) << (x % bits_per_word);
+        word = opaque ? (word | bit) : (word & ~bit);
+    }
+
+    bool COpacityMask::overlaps(const COpacityMask & other, int dx, int dy) const
+    {
+        const int top = std::max(0, dy);
+        const int bottom = std::min(m_height, dy + other.m_height);
+
+        for (int y = top; y < bottom; ++y)
+        {
+            const std::uint64_t * p_row = &m_words[y * m_wordsPerRow];
+            for (int word = 0; word < m_wordsPerRow; ++word)
+            {
+                if ((p_row[word] & other.bits(word * bits_per_word - dx, y - dy)) != 0)
+                {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+    std::uint64_t COpacityMask::bits(int x, int y) const
+    {
+        if (x <= -bits_per_word || x >= m_width)
+        {
+            return 0;
+        }
+
+        // Floor division, so pixels before the row fall in a word of index -1
+        const int word = (x >= 0 ? x : x - (bits_per_word - 1)) / bits_per_word;
+        const int shift = x - word * bits_per_word;
+        const std::uint64_t * p_row = &m_words[y * m_wordsPerRow];
+
+        const std::uint64_t low = word >= 0 ? p_row[word] : 0;
+        if (shift == 0)
+        {
+            return low;
+        }
+
+        const std::uint64_t high = word + 1 < m_wordsPerRow ? p_row[word + 1] : 0;
+        return (low >> shift) | (high << (bits_per_word - shift));
+    }
+
+} // namespace utils
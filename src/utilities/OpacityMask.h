@@ -0,0 +1,63 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#pragma once
+#include <cstdint>
+#include <vector>
+
+namespace utils {
+
+    /**
+     * @brief COpacityMask stores one bit per pixel of an image, set where the pixel is opaque.
+     * Each row is packed in 64-bit words, the leftmost pixel of a word being its lowest bit, so two
+     * masks are tested for overlap a whole word at a time
+     */
+    class COpacityMask final
+    {
+      public:
+        COpacityMask() = default;
+        COpacityMask(int width, int height);
+
+        inline int width() const noexcept { return m_width; }
+        inline int height() const noexcept { return m_height; }
+
+        bool testBit(int x, int y) const;
+        void setBit(int x, int y, bool opaque);
+
+        /**
+         * @brief Returns true if at least one opaque pixel of this mask lies on an opaque pixel of
+         * the other mask, whose top left corner is placed at (dx, dy) relative to this mask
+         */
+        bool overlaps(const COpacityMask & other, int dx, int dy) const;
+
+      private:
+        /**
+         * @brief Retrieves the 64 pixels of the given row starting at pixel x, which may lie
+         * outside the mask. Pixels outside the mask are transparent
+         */
+        std::uint64_t bits(int x, int y) const;
+
+      private:
+        int m_width{0};
+        int m_height{0};
+        int m_wordsPerRow{0};
+        std::vector<std::uint64_t> m_words;
+    };
+
+} // namespace utils
@@ -19,17 +19,28 @@
 
 #include "Path.h"
 
+#if defined(_WIN32)
 #define WIN32_LEAN_AND_MEAN
 #define NOMINMAX
 #include <windows.h>
+#else
+#include <climits>
+#include <unistd.h>
+#endif
 
 namespace utils {
     namespace path_utils {
 
         std::string executablePath()
         {
+#if defined(_WIN32)
             char buffer[MAX_PATH];
             GetModuleFileName(nullptr, buffer, MAX_PATH);
+#else
+            char buffer[PATH_MAX] = {'\0'};
+            const ssize_t length = readlink("/proc/self/exe", buffer, PATH_MAX - 1);
+            buffer[length > 0 ? length : 0] = '\0';
+#endif
             std::string::size_type pos = std::string(buffer).find_last_of("\\/");
             return std::string(buffer).substr(0, pos);
         }
@@ -20,13 +20,17 @@
 #include "Path.h"
 #include "Picture.h"
 #include <cassert>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <vector>
 
 namespace utils {
 
     CPicture::CPicture(const char * imagePath) { setImage(imagePath); }
 
-    CPicture::CPicture(const char * imagePath, const CRectangle & shape) : m_shape(shape)
+    CPicture::CPicture(const char * imagePath, const CRectangle & shape, bool buildOpacityMask)
+        : m_shape(shape), m_buildOpacityMask(buildOpacityMask)
     {
         setImage(imagePath);
     }
@@ -36,14 +40,15 @@ namespace utils {
         assert(imagePath && imagePath[0]);
         m_imagePath = imagePath;
 
-        // m_size = CSize(32, 32);
-        assert(readImage());
+        const bool image_read = readImage();
+        assert(image_read);
+        (void)image_read;
     }
 
     bool CPicture::readImage()
     {
         std::string path = path_utils::executablePath();
-        path += "\\";
+        path += "/";
         path += m_imagePath;
 
         std::ifstream file_input(path.c_str(), std::ios::in | std::ios::binary);
@@ -60,17 +65,79 @@ namespace utils {
             return false;
         }
 
+        file_input.seekg(0x0A, std::ios::beg);
+        unsigned int data_offset = 0;
+        file_input.read((char *)&data_offset, sizeof(unsigned int));
+
         file_input.seekg(0x12, std::ios::beg);
         unsigned int width = 0;
         file_input.read((char *)&width, sizeof(unsigned int));
 
-        unsigned int height = 0;
-        file_input.read((char *)&height, sizeof(unsigned int));
+        // A negative height marks the rows stored from the top to the bottom
+        int height = 0;
+        file_input.read((char *)&height, sizeof(int));
+
+        unsigned short bits_per_pixel = 0;
+        file_input.seekg(0x1C, std::ios::beg);
+        file_input.read((char *)&bits_per_pixel, sizeof(unsigned short));
+
+        m_size = CSize(width, std::abs(height));
+
+        if (m_buildOpacityMask && !readOpacityMask(file_input, data_offset, height, bits_per_pixel))
+        {
+            return false;
+        }
 
-        m_size = CSize(width, height);
         file_input.close();
 
         return true;
     }
 
+    bool CPicture::readOpacityMask(std::istream & input,
+                                   unsigned int dataOffset,
+                                   int height,
+                                   unsigned short bitsPerPixel)
+    {
+        // Only uncompressed true color images, the ones shipped with the game
+        if (bitsPerPixel != 24 && bitsPerPixel != 32)
+        {
+            return false;
+        }
+
+        const int width = static_cast<int>(m_size.width());
+        const int rows = std::abs(height);
+        const int bytes_per_pixel = bitsPerPixel / 8;
+        const int stride = ((width * bitsPerPixel + 31) / 32) * 4;
+
+        std::vector<unsigned char> row(stride);
+        std::shared_ptr<COpacityMask> p_mask = std::make_shared<COpacityMask>(width, rows);
+
+        input.seekg(dataOffset, std::ios::beg);
+        for (int i = 0; i < rows; ++i)
+        {
+            if (!input.read(reinterpret_cast<char *>(row.data()), stride))
+            {
+                return false;
+            }
+
+            const int y = height > 0 ? rows - 1 - i : i;
+            for (int x = 0; x < width; ++x)
+            {
+                // Pixels outside the shape do not take part in collisions
+                const CRectangle pixel(x, y, 1, 1);
+                if (!m_shape.contains(pixel))
+                {
+                    continue;
+                }
+
+                const unsigned char * p_pixel = &row[x * bytes_per_pixel];
+                const bool opaque = p_pixel[0] != 0 || p_pixel[1] != 0 || p_pixel[2] != 0;
+                p_mask->setBit(x, y, opaque);
+            }
+        }
+
+        m_pOpacityMask = p_mask;
+        return true;
+    }
+
 } // namespace utils
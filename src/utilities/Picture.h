@@ -18,7 +18,9 @@
 ****************************************************************************************/
 
 #pragma once
+#include "OpacityMask.h"
 #include "Rectangle.h"
+#include <memory>
 #include <string>
 
 namespace utils {
@@ -28,7 +30,7 @@ namespace utils {
 	public:
 		CPicture() = default;
 		CPicture(const char * imagePath);
-		CPicture(const char * imagePath, const CRectangle & shape);
+		CPicture(const char * imagePath, const CRectangle & shape, bool buildOpacityMask = false);
 
 		inline bool isNull() const { return m_imagePath.empty(); }
 		inline bool isEmpty() const { return m_imagePath.empty(); }
@@ -45,13 +47,30 @@ namespace utils {
 
 		inline CRectangle rectangle() const noexcept { return CRectangle(0, 0, m_size.width(), m_size.height()); }
 
+		/**
+		 * @brief Retrieves the mask of the opaque pixels of the image lying inside the shape, or nullptr when the picture
+		 * was not asked to build one. Black pixels are transparent. The mask is shared by the copies of the picture
+		 */
+		inline const std::shared_ptr<const COpacityMask> & opacityMask() const noexcept { return m_pOpacityMask; }
+
+		/**
+		 * @brief Retrieves the rectangle of the image in the texture atlas of the game, empty when the picture has not
+		 * been packed in an atlas
+		 */
+		inline const CRectangle & atlasRectangle() const noexcept { return m_atlasRectangle; }
+		inline void setAtlasRectangle(const CRectangle & rectangle) noexcept { m_atlasRectangle = rectangle; }
+
 	private:
 		bool readImage();
+		bool readOpacityMask(std::istream & input, unsigned int dataOffset, int height, unsigned short bitsPerPixel);
 
 	private:
 		std::string m_imagePath;
 		CSize m_size;
 		CRectangle m_shape;
+		bool m_buildOpacityMask{ false };
+		std::shared_ptr<const COpacityMask> m_pOpacityMask;
+		CRectangle m_atlasRectangle;
 	};
 
 } // namespace utils
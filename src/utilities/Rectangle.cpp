@@ -19,6 +19,7 @@
 
 #include "MathUtils.h"
 #include "Rectangle.h"
+#include <algorithm>
 
 namespace utils {
 
@@ -80,6 +81,26 @@ namespace utils {
 		return true;
 	}
 
+	CRectangle CRectangle::united(const CRectangle &r) const noexcept
+	{
+		const double left = std::min(m_x, r.m_x);
+		const double top = std::min(m_y, r.m_y);
+		const double right = std::max(m_x + m_width, r.m_x + r.m_width);
+		const double bottom = std::max(m_y + m_height, r.m_y + r.m_height);
+
+		return CRectangle(left, top, right - left, bottom - top);
+	}
+
+	CRectangle CRectangle::intersected(const CRectangle &r) const noexcept
+	{
+		const double left = std::max(m_x, r.m_x);
+		const double top = std::max(m_y, r.m_y);
+		const double right = std::min(m_x + m_width, r.m_x + r.m_width);
+		const double bottom = std::min(m_y + m_height, r.m_y + r.m_height);
+
+		return CRectangle(left, top, right - left, bottom - top);
+	}
+
 	bool operator==(const CRectangle &r1, const CRectangle &r2) noexcept
 	{
 		return math::gFuzzyCompare(r1.m_x, r2.m_x) && math::gFuzzyCompare(r1.m_y, r2.m_y)
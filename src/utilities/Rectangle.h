@@ -58,6 +58,17 @@ namespace utils {
 		bool contains(const CRectangle &r) const noexcept;
 		bool intersects(const CRectangle &r) const noexcept;
 
+		/**
+		 * @brief Returns the smallest rectangle containing both rectangles. Empty rectangles still
+		 * extend the result with their position
+		 */
+		CRectangle united(const CRectangle &r) const noexcept;
+
+		/**
+		 * @brief Returns the overlap of both rectangles. The size is negative when they do not overlap
+		 */
+		CRectangle intersected(const CRectangle &r) const noexcept;
+
 		friend bool operator==(const CRectangle &, const CRectangle &) noexcept;
 		friend bool operator!=(const CRectangle &, const CRectangle &) noexcept;
 
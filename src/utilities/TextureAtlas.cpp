@@ -0,0 +1,93 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#include "TextureAtlas.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <numeric>
+
+namespace utils {
+
+    CTextureAtlas::CTextureAtlas(int maxWidth, int spacing)
+        : m_maxWidth(maxWidth), m_spacing(spacing)
+    {
+        assert(maxWidth > 0 && spacing >= 0);
+    }
+
+    size_t CTextureAtlas::addImage(const CBitmapImage & image)
+    {
+        assert(!image.isNull());
+
+        m_images.push_back(image);
+        m_rectangles.push_back(CRectangle());
+        return m_images.size() - 1;
+    }
+
+    bool CTextureAtlas::pack()
+    {
+        std::vector<size_t> order(m_images.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+            return m_images[a].height() > m_images[b].height();
+        });
+
+        int shelf_x = 0;
+        int shelf_y = 0;
+        int shelf_height = 0;
+        int width = 0;
+        for (size_t index : order)
+        {
+            const CBitmapImage & image = m_images[index];
+            if (image.width() > m_maxWidth)
+            {
+                return false;
+            }
+
+            if (shelf_x + image.width() > m_maxWidth)
+            {
+                shelf_x = 0;
+                shelf_y += shelf_height + m_spacing;
+                shelf_height = 0;
+            }
+
+            m_rectangles[index] = CRectangle(shelf_x, shelf_y, image.width(), image.height());
+            width = std::max(width, shelf_x + image.width());
+            shelf_height = std::max(shelf_height, image.height());
+            shelf_x += image.width() + m_spacing;
+        }
+
+        m_image = CBitmapImage(width, shelf_y + shelf_height);
+        for (size_t index = 0; index < m_images.size(); ++index)
+        {
+            const CBitmapImage & image = m_images[index];
+            const int x = (int)m_rectangles[index].x();
+            const int y = (int)m_rectangles[index].y();
+            for (int row = 0; row < image.height(); ++row)
+            {
+                memcpy(m_image.scanLine(y + row) + x,
+                       image.scanLine(row),
+                       image.width() * sizeof(std::uint32_t));
+            }
+        }
+
+        return true;
+    }
+
+} // namespace utils
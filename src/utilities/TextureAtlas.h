@@ -0,0 +1,67 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#pragma once
+#include "BitmapImage.h"
+#include "Rectangle.h"
+#include <vector>
+
+namespace utils {
+
+    /**
+     * @brief CTextureAtlas packs several images in a single one with a shelf packer: the images
+     * are sorted by decreasing height and laid out from left to right on horizontal shelves, a
+     * new shelf being opened when the current one is full. Images are kept apart by the spacing
+     * so no pixel of an image can bleed into another one
+     */
+    class CTextureAtlas final
+    {
+      public:
+        explicit CTextureAtlas(int maxWidth = 1024, int spacing = 1);
+        CTextureAtlas(const CTextureAtlas &) = delete;
+        CTextureAtlas & operator=(const CTextureAtlas &) = delete;
+
+        /**
+         * @brief Adds an image to the atlas and returns its index. The image is copied
+         */
+        size_t addImage(const CBitmapImage & image);
+
+        /**
+         * @brief Packs all the images added so far. Returns false if an image is wider than the
+         * maximum width of the atlas
+         */
+        bool pack();
+
+        inline const CBitmapImage & image() const noexcept { return m_image; }
+        inline size_t count() const noexcept { return m_images.size(); }
+
+        /**
+         * @brief Retrieves the rectangle of the image with the given index in the packed atlas
+         */
+        inline const CRectangle & rectangle(size_t index) const { return m_rectangles[index]; }
+
+      private:
+        int m_maxWidth;
+        int m_spacing;
+        std::vector<CBitmapImage> m_images;
+        std::vector<CRectangle> m_rectangles;
+        CBitmapImage m_image;
+    };
+
+} // namespace utils
@@ -0,0 +1,249 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#include "TestUtils.h"
+#include <BitmapFont.h>
+#include <DrawList.h>
+#include <DrawTrace.h>
+#include <IPlatform.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace {
+
+    typedef utils::CDrawTraceReader::record_type record_type;
+    typedef std::vector<utils::CDrawTraceReader::SRecord> TRecords;
+
+    static const char * trace_path = "DrawTraceTest.trace";
+    static const char * truncated_trace_path = "DrawTraceTest.truncated.trace";
+
+    class CSprite final : public utils::interfaces::ISprite
+    {
+      public:
+        void destroy() override {}
+        void draw(int /*x*/, int /*y*/) override {}
+    };
+
+    utils::CDrawTraceReader::SRecord makeRecord(record_type type,
+                                                int x = 0,
+                                                int y = 0,
+                                                const std::string & text = std::string(),
+                                                std::uint16_t sprite = 0)
+    {
+        utils::CDrawTraceReader::SRecord record;
+        record.type = type;
+        record.sprite = sprite;
+        record.x = x;
+        record.y = y;
+        record.text = text;
+        return record;
+    }
+
+    int randomCoordinate() { return rand() % 2000 - 1000; }
+
+    /**
+     * @brief Records random frames of sprites, texts and glyphs, and returns the records the
+     * trace must hold
+     */
+    TRecords record()
+    {
+        TRecords expected;
+
+        utils::CDrawTraceWriter writer;
+        TEST_CHECK(writer.open(trace_path, 448, 544));
+
+        // Redefining a sprite at the same address gives it a new id
+        CSprite sprites[4];
+        std::uint16_t sprite_ids[4] = {};
+        std::uint16_t next_sprite_id = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            const std::string path = "images/sprite" + std::to_string(i) + ".bmp";
+            writer.defineSprite(&sprites[i], path.c_str());
+            sprite_ids[i] = next_sprite_id++;
+            expected.push_back(makeRecord(record_type::sprite, 0, 0, path, sprite_ids[i]));
+        }
+
+        utils::CDrawList draw_list;
+        for (int frame = 0; frame < 50; ++frame)
+        {
+            if (rand() % 5 == 0)
+            {
+                const int i = rand() % 4;
+                const std::string path = "images/frame" + std::to_string(frame) + ".bmp";
+                writer.defineSprite(&sprites[i], path.c_str());
+                sprite_ids[i] = next_sprite_id++;
+                expected.push_back(makeRecord(record_type::sprite, 0, 0, path, sprite_ids[i]));
+            }
+
+            draw_list.clear();
+            const int commands = rand() % 20;
+            for (int command = 0; command < commands; ++command)
+            {
+                const int x = randomCoordinate();
+                const int y = randomCoordinate();
+                switch (rand() % 3)
+                {
+                    case 0:
+                    {
+                        const int i = rand() % 4;
+                        draw_list.addSprite(&sprites[i], x, y);
+                        expected.push_back(
+                            makeRecord(record_type::draw, x, y, std::string(), sprite_ids[i]));
+                        break;
+                    }
+
+                    case 1:
+                    {
+                        const std::string text(rand() % 12, (char)('a' + rand() % 26));
+                        draw_list.addText(x, y, text.c_str());
+                        expected.push_back(makeRecord(record_type::text, x, y, text));
+                        break;
+                    }
+
+                    default:
+                    {
+                        const char character = (char)(utils::CBitmapFont::first_glyph +
+                                                      rand() % utils::CBitmapFont::glyph_count);
+                        draw_list.addGlyph(x, y, character, utils::CRectangle(0, 0, 8, 8));
+                        expected.push_back(
+                            makeRecord(record_type::glyph, x, y, std::string(1, character)));
+                        break;
+                    }
+                }
+            }
+
+            writer.writeFrame(draw_list);
+            expected.push_back(makeRecord(record_type::frame));
+        }
+
+        TEST_CHECK(writer.frames() == 50);
+        writer.close();
+
+        return expected;
+    }
+
+    /**
+     * @brief Reads the records of a trace until its end or a damaged record
+     */
+    TRecords replay(const char * tracePath)
+    {
+        TRecords records;
+
+        utils::CDrawTraceReader reader;
+        if (!reader.open(tracePath))
+        {
+            return records;
+        }
+
+        TEST_CHECK(reader.width() == 448);
+        TEST_CHECK(reader.height() == 544);
+
+        utils::CDrawTraceReader::SRecord record;
+        while (reader.read(record))
+        {
+            records.push_back(record);
+        }
+
+        return records;
+    }
+
+    /**
+     * @brief Compares the fields the type of the records makes use of
+     */
+    bool equals(const utils::CDrawTraceReader::SRecord & record,
+                const utils::CDrawTraceReader::SRecord & other)
+    {
+        if (record.type != other.type)
+        {
+            return false;
+        }
+
+        switch (record.type)
+        {
+            case record_type::sprite:
+                return (record.sprite == other.sprite) && (record.text == other.text);
+
+            case record_type::draw:
+                return (record.sprite == other.sprite) && (record.x == other.x) &&
+                       (record.y == other.y);
+
+            case record_type::text:
+            case record_type::glyph:
+                return (record.x == other.x) && (record.y == other.y) &&
+                       (record.text == other.text);
+
+            case record_type::frame:
+                return true;
+        }
+
+        return false;
+    }
+
+} // namespace
+
+int main()
+{
+    srand(1);
+
+    const TRecords expected = record();
+    const TRecords records = replay(trace_path);
+
+    TEST_CHECK(records.size() == expected.size());
+    for (size_t i = 0; (i < records.size()) && (i < expected.size()); ++i)
+    {
+        TEST_CHECK(equals(records[i], expected[i]));
+    }
+
+    // A trace cut in its middle reads up to the cut
+    std::ifstream trace(trace_path, std::ios::binary);
+    const std::string bytes((std::istreambuf_iterator<char>(trace)),
+                            std::istreambuf_iterator<char>());
+    trace.close();
+
+    std::ofstream truncated(truncated_trace_path, std::ios::binary | std::ios::trunc);
+    truncated.write(bytes.data(), bytes.size() / 2);
+    truncated.close();
+
+    const TRecords truncated_records = replay(truncated_trace_path);
+    TEST_CHECK(!truncated_records.empty());
+    TEST_CHECK(truncated_records.size() < expected.size());
+    for (size_t i = 0; i < truncated_records.size(); ++i)
+    {
+        TEST_CHECK(equals(truncated_records[i], expected[i]));
+    }
+
+    // A file which is not a trace is refused
+    std::ofstream other(truncated_trace_path, std::ios::binary | std::ios::trunc);
+    other << "LIDX not a trace";
+    other.close();
+
+    utils::CDrawTraceReader reader;
+    TEST_CHECK(!reader.open(truncated_trace_path));
+
+    std::remove(trace_path);
+    std::remove(truncated_trace_path);
+
+    return tests::failures();
+}
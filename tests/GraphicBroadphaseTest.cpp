@@ -0,0 +1,265 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#include "GraphicGrid.h"
+#include "GraphicItem.h"
+#include "GraphicSweepAndPrune.h"
+#include "TestUtils.h"
+#include <algorithm>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    using engine::graphic::CGraphicBroadphase;
+    using engine::graphic::CGraphicGrid;
+    using engine::graphic::CGraphicItem;
+    using engine::graphic::CGraphicSweepAndPrune;
+    using utils::interfaces::IGraphicItem;
+
+    typedef std::vector<int> TIds;
+    typedef std::vector<std::pair<int, int>> TIdsPairs;
+
+    class CLeaf final : public CGraphicItem
+    {
+      public:
+        CLeaf(CGraphicItem * pParent, int id) : CGraphicItem(pParent), m_id(id) {}
+
+        inline int id() const noexcept { return m_id; }
+
+        void draw(int /*x*/, int /*y*/) override {}
+
+      private:
+        const int m_id;
+    };
+
+    class CArea final : public CGraphicItem
+    {
+      public:
+        explicit CArea(CGraphicBroadphase * pIndex)
+        {
+            setSize(400, 400);
+            setBroadphaseIndex(pIndex);
+        }
+
+        const CGraphicBroadphase * index() const { return broadphaseIndex(); }
+
+        void draw(int /*x*/, int /*y*/) override {}
+    };
+
+    /**
+     * @brief The same scene built twice, in an area indexed by the broadphase under test and in
+     * an area testing every child
+     */
+    class CScene final
+    {
+      public:
+        explicit CScene(CGraphicBroadphase * pIndex) : m_indexed(pIndex), m_bruteForce(nullptr) {}
+
+        ~CScene()
+        {
+            for (size_t i = 0; i < m_indexedLeaves.size(); ++i)
+            {
+                delete m_indexedLeaves[i];
+                delete m_bruteForceLeaves[i];
+            }
+        }
+
+        void add()
+        {
+            const int id = m_nextId++;
+            m_indexedLeaves.push_back(new CLeaf(&m_indexed, id));
+            m_bruteForceLeaves.push_back(new CLeaf(&m_bruteForce, id));
+            move(m_indexedLeaves.size() - 1);
+        }
+
+        void remove(size_t index)
+        {
+            delete m_indexedLeaves[index];
+            delete m_bruteForceLeaves[index];
+            m_indexedLeaves.erase(m_indexedLeaves.begin() + index);
+            m_bruteForceLeaves.erase(m_bruteForceLeaves.begin() + index);
+        }
+
+        /**
+         * @brief Moves and resizes a leaf to a random rectangle, partly outside of the area
+         */
+        void move(size_t index)
+        {
+            const double x = rand() % 480 - 40;
+            const double y = rand() % 480 - 40;
+            const double width = rand() % 40;
+            const double height = rand() % 40;
+            m_indexedLeaves[index]->setRectangle(x, y, width, height);
+            m_bruteForceLeaves[index]->setRectangle(x, y, width, height);
+        }
+
+        void step()
+        {
+            switch (rand() % 8)
+            {
+                case 0:
+                    remove(rand() % m_indexedLeaves.size());
+                    add();
+                    break;
+                case 1:
+                    CGraphicItem::advanceFrame();
+                    break;
+                default:
+                    move(rand() % m_indexedLeaves.size());
+                    break;
+            }
+        }
+
+        size_t size() const { return m_indexedLeaves.size(); }
+        const CArea & indexed() const { return m_indexed; }
+        const CArea & bruteForce() const { return m_bruteForce; }
+        const CLeaf * indexedLeaf(size_t index) const { return m_indexedLeaves[index]; }
+        const CLeaf * bruteForceLeaf(size_t index) const { return m_bruteForceLeaves[index]; }
+
+      private:
+        CArea m_indexed;
+        CArea m_bruteForce;
+        std::vector<CLeaf *> m_indexedLeaves;
+        std::vector<CLeaf *> m_bruteForceLeaves;
+        int m_nextId{0};
+    };
+
+    TIds ids(const IGraphicItem::TGraphicItems & items)
+    {
+        TIds ids;
+        for (const IGraphicItem * p_item : items)
+        {
+            ids.push_back(dynamic_cast<const CLeaf *>(p_item)->id());
+        }
+
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+
+    /**
+     * @brief Checks the queries of the indexed area against the brute force one, in every mode
+     */
+    void checkQueries(const CScene & scene)
+    {
+        const utils::CRectangle rectangle(
+            rand() % 440 - 20, rand() % 440 - 20, rand() % 120 + 1, rand() % 120 + 1);
+        const size_t index = rand() % scene.size();
+
+        for (int mode = 0; mode <= (int)IGraphicItem::collision_mode::swept_intersect; ++mode)
+        {
+            const auto collision_mode = static_cast<IGraphicItem::collision_mode>(mode);
+
+            TEST_CHECK(ids(scene.indexed().collidingItems(rectangle, collision_mode)) ==
+                       ids(scene.bruteForce().collidingItems(rectangle, collision_mode)));
+
+            TEST_CHECK(
+                ids(scene.indexed().collidingItems(scene.indexedLeaf(index), collision_mode)) ==
+                ids(scene.bruteForce().collidingItems(scene.bruteForceLeaf(index),
+                                                      collision_mode)));
+        }
+    }
+
+    /**
+     * @brief Checks that the sweep and prune reports once each pair of leaves whose swept shapes
+     * overlap, borders included. It may report more candidates, e.g. with the bounds an item had
+     * before the frame advanced
+     */
+    void checkPairs(const CScene & scene)
+    {
+        auto * p_index = static_cast<const CGraphicSweepAndPrune *>(scene.indexed().index());
+        CGraphicBroadphase::TItemsPairs pairs;
+        p_index->pairs(pairs);
+
+        TIdsPairs found;
+        for (const auto & pair : pairs)
+        {
+            const int id = static_cast<const CLeaf *>(pair.first)->id();
+            const int other_id = static_cast<const CLeaf *>(pair.second)->id();
+            found.push_back(std::make_pair(std::min(id, other_id), std::max(id, other_id)));
+        }
+
+        TIdsPairs expected;
+        for (size_t i = 0; i < scene.size(); ++i)
+        {
+            const utils::CRectangle shape = scene.indexedLeaf(i)->sweptShape();
+            for (size_t k = i + 1; k < scene.size(); ++k)
+            {
+                const utils::CRectangle other = scene.indexedLeaf(k)->sweptShape();
+                if (shape.x() <= other.x() + other.width() &&
+                    other.x() <= shape.x() + shape.width() &&
+                    shape.y() <= other.y() + other.height() &&
+                    other.y() <= shape.y() + shape.height())
+                {
+                    const int id = scene.indexedLeaf(i)->id();
+                    const int other_id = scene.indexedLeaf(k)->id();
+                    expected.push_back(
+                        std::make_pair(std::min(id, other_id), std::max(id, other_id)));
+                }
+            }
+        }
+
+        std::sort(found.begin(), found.end());
+        std::sort(expected.begin(), expected.end());
+        TEST_CHECK(std::adjacent_find(found.begin(), found.end()) == found.end());
+        TEST_CHECK(std::includes(found.begin(), found.end(), expected.begin(), expected.end()));
+    }
+
+} // namespace
+
+int main()
+{
+    srand(1);
+
+    {
+        CScene scene(new CGraphicGrid(32));
+        for (int i = 0; i < 200; ++i)
+        {
+            scene.add();
+        }
+
+        for (int i = 0; i < 2000; ++i)
+        {
+            scene.step();
+            checkQueries(scene);
+        }
+    }
+
+    {
+        CScene scene(new CGraphicSweepAndPrune());
+        for (int i = 0; i < 200; ++i)
+        {
+            scene.add();
+        }
+
+        for (int i = 0; i < 2000; ++i)
+        {
+            scene.step();
+            checkQueries(scene);
+
+            if (i % 10 == 0)
+            {
+                checkPairs(scene);
+            }
+        }
+    }
+
+    return tests::failures();
+}
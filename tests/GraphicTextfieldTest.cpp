@@ -0,0 +1,73 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#include "GraphicContainer.h"
+#include "TestUtils.h"
+#include <IGraphicTextfield.h>
+#include <climits>
+#include <cstdio>
+#include <string>
+
+namespace {
+
+    /**
+     * @brief Checks setNumber writes the same text as the printf formatting of setText
+     */
+    void checkNumber(utils::interfaces::IGraphicTextfield * pTextfield,
+                     const char * prefix,
+                     int value)
+    {
+        char expected[64];
+        std::snprintf(expected, sizeof(expected), "%s%d", prefix, value);
+
+        pTextfield->setNumber(prefix, value);
+        TEST_CHECK(std::string(pTextfield->text()) == expected);
+    }
+
+} // namespace
+
+int main()
+{
+    tests::CEngineEnvironment environment;
+
+    {
+        engine::graphic::CGraphicContainer root;
+        utils::interfaces::IGraphicTextfield * p_textfield = root.addTextfield();
+
+        const int values[] = {0, 1, -1, 9, 10, -10, 12345, -98765, INT_MAX, INT_MIN};
+        for (int value : values)
+        {
+            checkNumber(p_textfield, "Score: ", value);
+            checkNumber(p_textfield, "", value);
+        }
+
+        // The text is replaced, whether it was set by setText or by setNumber
+        p_textfield->setText("Lives: %d", 3);
+        checkNumber(p_textfield, "Lives: ", 3);
+        checkNumber(p_textfield, "Lives: ", 2);
+
+        // A prefix buffer reused with other contents
+        char prefix[16] = "Wave ";
+        checkNumber(p_textfield, prefix, 4);
+        prefix[0] = 'w';
+        checkNumber(p_textfield, prefix, 4);
+    }
+
+    return tests::failures();
+}
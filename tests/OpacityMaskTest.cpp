@@ -0,0 +1,99 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#include "TestUtils.h"
+#include <OpacityMask.h>
+#include <cstdlib>
+
+namespace {
+
+    /**
+     * @brief Builds a mask of random opaque pixels, roughly one in density
+     */
+    utils::COpacityMask randomMask(int width, int height, int density)
+    {
+        utils::COpacityMask mask(width, height);
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                mask.setBit(x, y, rand() % density == 0);
+            }
+        }
+
+        return mask;
+    }
+
+    bool overlapsBruteForce(const utils::COpacityMask & mask,
+                            const utils::COpacityMask & other,
+                            int dx,
+                            int dy)
+    {
+        for (int y = 0; y < other.height(); ++y)
+        {
+            for (int x = 0; x < other.width(); ++x)
+            {
+                const int mask_x = x + dx;
+                const int mask_y = y + dy;
+                if (other.testBit(x, y) && mask_x >= 0 && mask_x < mask.width() && mask_y >= 0 &&
+                    mask_y < mask.height() && mask.testBit(mask_x, mask_y))
+                {
+                    return true;
+                }
+            }
+        }
+
+        return false;
+    }
+
+} // namespace
+
+int main()
+{
+    srand(1);
+
+    // The widths cross the 64 pixel words, the offsets also move the masks apart
+    for (int i = 0; i < 100; ++i)
+    {
+        const utils::COpacityMask mask = randomMask(rand() % 150 + 1, rand() % 20 + 1, 40);
+        const utils::COpacityMask other = randomMask(rand() % 150 + 1, rand() % 20 + 1, 40);
+
+        for (int dy = -other.height() - 1; dy <= mask.height() + 1; dy += 3)
+        {
+            for (int dx = -other.width() - 1; dx <= mask.width() + 1; ++dx)
+            {
+                const bool overlaps = mask.overlaps(other, dx, dy);
+                TEST_CHECK(overlaps == overlapsBruteForce(mask, other, dx, dy));
+                TEST_CHECK(overlaps == other.overlaps(mask, -dx, -dy));
+            }
+        }
+    }
+
+    // A single opaque pixel of each mask, on both sides of a word boundary
+    utils::COpacityMask mask(130, 1);
+    mask.setBit(64, 0, true);
+    utils::COpacityMask other(70, 1);
+    other.setBit(0, 0, true);
+    TEST_CHECK(mask.overlaps(other, 64, 0));
+    TEST_CHECK(!mask.overlaps(other, 63, 0));
+    TEST_CHECK(!mask.overlaps(other, 65, 0));
+    TEST_CHECK(!mask.overlaps(other, 64, 1));
+
+    return tests::failures();
+}
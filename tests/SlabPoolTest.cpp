@@ -0,0 +1,164 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#include "GraphicContainer.h"
+#include "SlabPool.h"
+#include "TestUtils.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+    typedef std::vector<void *> TBlocks;
+
+    TBlocks allocate(engine::CSlabPool & pool, size_t count)
+    {
+        TBlocks blocks;
+        for (size_t i = 0; i < count; ++i)
+        {
+            blocks.push_back(pool.allocate());
+        }
+
+        return blocks;
+    }
+
+    /**
+     * @brief Fills each block with its index and checks no other block overwrote it
+     */
+    void checkDisjoint(const engine::CSlabPool & pool, const TBlocks & blocks)
+    {
+        for (size_t i = 0; i < blocks.size(); ++i)
+        {
+            TEST_CHECK(reinterpret_cast<std::uintptr_t>(blocks[i]) % alignof(std::max_align_t) ==
+                       0);
+            std::memset(blocks[i], static_cast<int>(i), pool.blockSize());
+        }
+
+        for (size_t i = 0; i < blocks.size(); ++i)
+        {
+            const unsigned char * p_bytes = static_cast<const unsigned char *>(blocks[i]);
+            TEST_CHECK(p_bytes[0] == static_cast<unsigned char>(i));
+            TEST_CHECK(p_bytes[pool.blockSize() - 1] == static_cast<unsigned char>(i));
+        }
+    }
+
+    void checkPool()
+    {
+        engine::CSlabPool pool(24, 4);
+        TEST_CHECK(pool.blockSize() >= 24);
+        TEST_CHECK(pool.blockSize() % alignof(std::max_align_t) == 0);
+        TEST_CHECK(pool.slabs() == 0);
+
+        // Ten blocks span three slabs of four
+        TBlocks blocks = allocate(pool, 10);
+        TEST_CHECK(pool.allocatedBlocks() == 10);
+        TEST_CHECK(pool.slabs() == 3);
+        checkDisjoint(pool, blocks);
+
+        // Released blocks are reused before any new slab
+        for (void * p_block : blocks)
+        {
+            pool.release(p_block);
+        }
+
+        TEST_CHECK(pool.allocatedBlocks() == 0);
+
+        TBlocks reused = allocate(pool, 10);
+        TEST_CHECK(pool.slabs() == 3);
+        std::sort(blocks.begin(), blocks.end());
+        std::sort(reused.begin(), reused.end());
+        TEST_CHECK(blocks == reused);
+
+        // Releasing the blocks at the end of a slab and the start of the next one, the last
+        // released is handed out first
+        pool.release(reused[3]);
+        pool.release(reused[4]);
+        TEST_CHECK(pool.allocatedBlocks() == 8);
+        void * p_block = pool.allocate();
+        void * p_other = pool.allocate();
+        TEST_CHECK(p_block == reused[4]);
+        TEST_CHECK(p_other == reused[3]);
+        TEST_CHECK(pool.slabs() == 3);
+
+        // Past the free blocks, a new slab is added
+        TBlocks more = allocate(pool, 3);
+        TEST_CHECK(pool.slabs() == 4);
+        TEST_CHECK(pool.allocatedBlocks() == 13);
+
+        reused.insert(reused.end(), more.begin(), more.end());
+        checkDisjoint(pool, reused);
+
+        for (void * p_reused : reused)
+        {
+            pool.release(p_reused);
+        }
+
+        TEST_CHECK(pool.allocatedBlocks() == 0);
+    }
+
+    /**
+     * @brief The items allocated from the pools of the framework give their blocks back when
+     * deleted
+     */
+    void checkItems()
+    {
+        tests::CEngineEnvironment environment;
+        auto * p_framework = static_cast<engine::CFramework *>(g_env->pFramework);
+        engine::CSlabPool & containers =
+            p_framework->itemPool(engine::graphic::CGraphicItem::item_type::container);
+        engine::CSlabPool & textfields =
+            p_framework->itemPool(engine::graphic::CGraphicItem::item_type::textfield);
+
+        for (int round = 0; round < 2; ++round)
+        {
+            auto * p_root = new engine::graphic::CGraphicContainer();
+            for (int i = 0; i < 150; ++i)
+            {
+                p_root->addContainer();
+                p_root->addTextfield("text");
+            }
+
+            TEST_CHECK(containers.allocatedBlocks() == 151);
+            TEST_CHECK(textfields.allocatedBlocks() == 150);
+
+            const size_t container_slabs = containers.slabs();
+            const size_t textfield_slabs = textfields.slabs();
+
+            delete p_root;
+            TEST_CHECK(containers.allocatedBlocks() == 0);
+            TEST_CHECK(textfields.allocatedBlocks() == 0);
+
+            // The slabs are kept for the next round
+            TEST_CHECK(containers.slabs() == container_slabs);
+            TEST_CHECK(textfields.slabs() == textfield_slabs);
+        }
+    }
+
+} // namespace
+
+int main()
+{
+    checkPool();
+    checkItems();
+
+    return tests::failures();
+}
@@ -0,0 +1,130 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#include "GraphicGrid.h"
+#include "GraphicItem.h"
+#include "GraphicSweepAndPrune.h"
+#include "TestUtils.h"
+#include <algorithm>
+
+namespace {
+
+    using engine::graphic::CGraphicBroadphase;
+    using engine::graphic::CGraphicGrid;
+    using engine::graphic::CGraphicItem;
+    using engine::graphic::CGraphicSweepAndPrune;
+    using utils::interfaces::IGraphicItem;
+
+    class CLeaf final : public CGraphicItem
+    {
+      public:
+        explicit CLeaf(CGraphicItem * pParent) : CGraphicItem(pParent) {}
+
+        void draw(int /*x*/, int /*y*/) override {}
+    };
+
+    class CArea final : public CGraphicItem
+    {
+      public:
+        explicit CArea(CGraphicBroadphase * pIndex)
+        {
+            setSize(400, 400);
+            setBroadphaseIndex(pIndex);
+        }
+
+        void draw(int /*x*/, int /*y*/) override {}
+    };
+
+    bool contains(const IGraphicItem::TGraphicItems & items, const IGraphicItem * pItem)
+    {
+        return std::find(items.begin(), items.end(), pItem) != items.end();
+    }
+
+    /**
+     * @brief A bullet crosses a wall thinner than the distance it moves in a frame
+     */
+    void checkTunneling(CGraphicBroadphase * pIndex)
+    {
+        CArea area(pIndex);
+        CLeaf wall(&area);
+        wall.setRectangle(200, 100, 2, 100);
+        CLeaf bullet(&area);
+        bullet.setRectangle(100, 148, 4, 4);
+
+        CGraphicItem::advanceFrame();
+        bullet.setPosition(300, 148);
+
+        TEST_CHECK(!bullet.collidesWithItem(&wall, IGraphicItem::collision_mode::intersect));
+        TEST_CHECK(bullet.collidesWithItem(&wall, IGraphicItem::collision_mode::swept_intersect));
+        TEST_CHECK(wall.collidesWithItem(&bullet, IGraphicItem::collision_mode::swept_intersect));
+        TEST_CHECK(!contains(area.collidingItems(&bullet, IGraphicItem::collision_mode::intersect),
+                             &wall));
+        TEST_CHECK(contains(
+            area.collidingItems(&bullet, IGraphicItem::collision_mode::swept_intersect), &wall));
+
+        // Once the frame is over, the bullet is only where it stopped
+        CGraphicItem::advanceFrame();
+        TEST_CHECK(!bullet.collidesWithItem(&wall, IGraphicItem::collision_mode::swept_intersect));
+        TEST_CHECK(!contains(
+            area.collidingItems(&bullet, IGraphicItem::collision_mode::swept_intersect), &wall));
+
+        // Passing just below the wall
+        bullet.setPosition(100, 201);
+        CGraphicItem::advanceFrame();
+        bullet.setPosition(300, 201);
+        TEST_CHECK(!bullet.collidesWithItem(&wall, IGraphicItem::collision_mode::swept_intersect));
+
+        // Stopping just before it
+        bullet.setPosition(100, 148);
+        CGraphicItem::advanceFrame();
+        bullet.setPosition(195, 148);
+        TEST_CHECK(!bullet.collidesWithItem(&wall, IGraphicItem::collision_mode::swept_intersect));
+
+        // Moving along with it, so never closer
+        wall.setPosition(200, 100);
+        bullet.setPosition(100, 148);
+        CGraphicItem::advanceFrame();
+        wall.setPosition(300, 100);
+        bullet.setPosition(200, 148);
+        TEST_CHECK(!bullet.collidesWithItem(&wall, IGraphicItem::collision_mode::swept_intersect));
+    }
+
+} // namespace
+
+int main()
+{
+    checkTunneling(nullptr);
+    checkTunneling(new CGraphicGrid(32));
+    checkTunneling(new CGraphicSweepAndPrune());
+
+    // Two items crossing each other head on, both faster than their sizes
+    CArea area(nullptr);
+    CLeaf left(&area);
+    left.setRectangle(0, 0, 4, 4);
+    CLeaf right(&area);
+    right.setRectangle(50, 0, 4, 4);
+
+    CGraphicItem::advanceFrame();
+    left.setPosition(60, 0);
+    right.setPosition(-10, 0);
+    TEST_CHECK(!left.collidesWithItem(&right, IGraphicItem::collision_mode::intersect));
+    TEST_CHECK(left.collidesWithItem(&right, IGraphicItem::collision_mode::swept_intersect));
+
+    return tests::failures();
+}
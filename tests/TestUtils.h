@@ -0,0 +1,76 @@
+/****************************************************************************************
+** Copyright (C) 2015 Simone Angeloni
+** This file is part of The Little Invaders.
+**
+** The Little Invaders is free software: you can redistribute it and/or modify
+** it under the terms of the GNU General Public License as published by
+** the Free Software Foundation, either version 3 of the License, or
+** (at your option) any later version.
+**
+** The Little Invaders is distributed in the hope that it will be useful,
+** but WITHOUT ANY WARRANTY; without even the implied warranty of
+** MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+** GNU General Public License for more details.
+**
+** You should have received a copy of the GNU General Public License
+** along with The Little Invaders. If not, see <http://www.gnu.org/licenses/>
+**
+****************************************************************************************/
+
+#pragma once
+#include "Framework.h"
+#include <ISystemGlobalEnvironment.h>
+#include <iostream>
+
+extern utils::interfaces::SSystemGlobalEnvironment * g_env;
+
+namespace tests {
+
+    /**
+     * @brief Counts the failed checks. The tests return it from main, so ctest reports them
+     */
+    inline int & failures()
+    {
+        static int failures = 0;
+        return failures;
+    }
+
+    /**
+     * @brief CEngineEnvironment creates the framework as the launcher does, without initializing
+     * it, so the items allocated from its pools can be created
+     */
+    class CEngineEnvironment final
+    {
+      public:
+        CEngineEnvironment()
+        {
+            g_env = &m_env;
+            g_env->pFramework = new engine::CFramework();
+        }
+
+        ~CEngineEnvironment()
+        {
+            delete static_cast<engine::CFramework *>(g_env->pFramework);
+            g_env->pFramework = nullptr;
+            g_env = nullptr;
+        }
+
+        CEngineEnvironment(const CEngineEnvironment &) = delete;
+        CEngineEnvironment & operator=(const CEngineEnvironment &) = delete;
+
+      private:
+        utils::interfaces::SSystemGlobalEnvironment m_env;
+    };
+
+} // namespace tests
+
+#define TEST_CHECK(condition)                                                                    \
+    do                                                                                           \
+    {                                                                                            \
+        if (!(condition))                                                                        \
+        {                                                                                        \
+            ++tests::failures();                                                                 \
+            std::cerr << "[ERROR] " << __FILE__ << ":" << __LINE__ << ": " << #condition         \
+                      << std::endl;                                                              \
+        }                                                                                        \
+    } while (false)